@@ -0,0 +1,73 @@
+#ifndef __AHOCORASICK__
+	#define __AHOCORASICK__
+
+	#include "ReadStore.hpp"
+	#include <array>
+	#include <cstddef>
+	#include <cstdint>
+	#include <vector>
+
+	class AhoCorasick {
+		private:
+			// Nombre de symboles : A, C, G, T et N
+			static const int SIGMA = 5;
+
+			const ReadStore& reads;
+			std::vector<std::array<int32_t, SIGMA>> transitions{};
+			std::vector<int32_t> dictionary_links{};
+			std::vector<int32_t> first_patterns{};
+			std::vector<int32_t> next_patterns{};
+			std::vector<uint8_t> done{};
+			std::vector<int32_t> containers{};
+
+			/**
+			 * @brief Donne les symboles d'une séquence, les bases N étant distinguées des A.
+			 *
+			 * @param id L'identifiant de la séquence.
+			 * @param symbols Le tableau à remplir.
+			**/
+			void symbols(size_t id, std::vector<uint8_t>& symbols) const;
+
+			/**
+			 * @brief Marque les motifs reconnus dans un état et ceux de ses liens de dictionnaire.
+			 *
+			 * @param node L'état de l'automate.
+			 * @param text L'identifiant de la séquence parcourue, qui ne se contient pas elle-même.
+			**/
+			void report(int32_t node, int32_t text);
+
+		public:
+			/**
+			 * @brief Construit l'automate d'Aho-Corasick des motifs donnés (arbre des préfixes, liens d'échec et de dictionnaire).
+			 *
+			 * Les transitions manquantes sont complétées par celles des liens d'échec : chaque base ne coûte qu'une transition.
+			 *
+			 * @param reads Le stockage des séquences.
+			 * @param patterns Les identifiants des séquences à rechercher, les copies identiques partageant le même état.
+			 *
+			 * @return Une instance AhoCorasick.
+			**/
+			AhoCorasick(const ReadStore& reads, const std::vector<int32_t>& patterns);
+
+			/**
+			 * @brief Fait passer une séquence dans l'automate et marque les motifs qui y apparaissent, hormis elle-même.
+			 *
+			 * Un motif apparaissant dans une séquence de même longueur en est une copie identique : il n'est marqué que si la séquence
+			 * a un identifiant plus petit, la copie de plus petit identifiant d'un groupe n'étant jamais marquée par ses copies.
+			 * Un état dont tous les motifs (liens de dictionnaire compris) sont déjà marqués n'est plus parcouru.
+			 *
+			 * @param id L'identifiant de la séquence à parcourir.
+			**/
+			void scan(size_t id);
+
+			/**
+			 * @brief Donne la première séquence parcourue contenant un motif : plus longue, ou copie identique d'identifiant plus petit.
+			 *
+			 * @param id L'identifiant du motif.
+			 *
+			 * @return L'identifiant de la séquence contenant le motif, -1 si le motif n'est apparu dans aucune séquence retenue.
+			**/
+			int32_t container(size_t id) const;
+	};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef __CHAINLENGTHS__
+	#define __CHAINLENGTHS__
+
+	#include "OverlapGraph.hpp"
+	#include <cstdint>
+	#include <queue>
+	#include <utility>
+	#include <vector>
+
+	class ChainLengths {
+		private:
+			const OverlapGraph& overlap_graph;
+			std::vector<int32_t> nodes{};
+			std::vector<int32_t> lengths{};
+			std::vector<int32_t> predecessor_offsets{};
+			std::vector<int32_t> predecessors{};
+			std::priority_queue<std::pair<int32_t, int32_t>> candidates{};
+
+			/**
+			 * @brief Donne l'indice local d'un nœud, par recherche dichotomique dans la liste triée des nœuds.
+			 *
+			 * @param node L'identifiant du nœud.
+			 *
+			 * @return L'indice du nœud dans la liste des nœuds.
+			**/
+			int32_t index(int32_t node) const;
+
+			/**
+			 * @brief Donne la longueur du chemin partant d'un nœud, nulle si le nœud n'a pas de successeur.
+			 *
+			 * @param node Le nœud de départ.
+			 *
+			 * @return La longueur du chemin, au sens de FindBestNode.
+			**/
+			int32_t score(int32_t node) const;
+
+		public:
+			/**
+			 * @brief Calcule en une passe la longueur du chemin partant de chaque nœud présent.
+			 *
+			 * Chaque nœud ayant au plus un successeur, les longueurs s'obtiennent par programmation dynamique
+			 * le long des successeurs, les nœuds d'un cycle ayant tous la longueur du cycle.
+			 *
+			 * @param overlap_graph Le graphe de chevauchement.
+			 * @param nodes Les nœuds présents pris en compte, triés, fermés pour les successeurs présents (une composante, par exemple).
+			 *
+			 * @return Une instance ChainLengths.
+			**/
+			ChainLengths(const OverlapGraph& overlap_graph, const std::vector<int32_t>& nodes);
+
+			/**
+			 * @brief Donne le nœud présent ayant le plus long chemin (le premier en cas d'égalité).
+			 *
+			 * @return L'identifiant du meilleur nœud, -1 s'il ne reste aucun nœud.
+			**/
+			int32_t best_node();
+
+			/**
+			 * @brief Donne la longueur du chemin partant d'un nœud, telle que comparée par best_node.
+			 *
+			 * @param node L'identifiant du nœud.
+			 *
+			 * @return La longueur du chemin, nulle si le nœud n'a pas de successeur.
+			**/
+			int32_t length(int32_t node) const;
+
+			/**
+			 * @brief Met à jour les longueurs après le retrait d'une chaîne du graphe.
+			 *
+			 * Seuls les nœuds dont le chemin rejoignait la chaîne sont mis à jour : leur chemin s'arrête désormais juste avant elle.
+			 *
+			 * @param chain Les nœuds de la chaîne, dans l'ordre de parcours, déjà marqués absents dans le graphe.
+			**/
+			void remove_chain(const std::vector<int32_t>& chain);
+	};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef __CONTIGLAYOUTS__
+	#define __CONTIGLAYOUTS__
+
+	#include "ReadStore.hpp"
+	#include <cstddef>
+	#include <cstdint>
+	#include <span>
+	#include <string>
+	#include <vector>
+
+	/**
+	 * @brief Place d'une séquence dans un contig.
+	**/
+	struct Placement {
+		// Identifiant de la séquence
+		int32_t id;
+
+		// Chevauchement avec la séquence précédente du contig (0 pour la première)
+		int32_t overlap;
+	};
+
+	/**
+	 * @brief Contigs décrits par l'agencement de leurs séquences, sans stocker leurs bases.
+	 *
+	 * Les placements de tous les contigs se suivent dans un même tableau, une table de débuts (CSR)
+	 * délimitant ceux de chaque contig. Les séquences ne sont décodées qu'à la demande.
+	**/
+	class ContigLayouts {
+		private:
+			std::vector<Placement> placements{};
+			std::vector<uint64_t> starts{0};
+			std::vector<uint64_t> lengths{};
+
+		public:
+			/**
+			 * @brief Ajoute un contig à la fin de la liste.
+			 *
+			 * @param layout Les placements des séquences du contig, dans l'ordre.
+			 * @param length La longueur du contig.
+			 *
+			 * @return L'indice du contig ajouté.
+			**/
+			size_t add(std::span<const Placement> layout, size_t length);
+
+			/**
+			 * @brief Donne le nombre de contigs.
+			 *
+			 * @return Le nombre de contigs.
+			**/
+			size_t size() const;
+
+			/**
+			 * @brief Donne la longueur d'un contig, sans le décoder.
+			 *
+			 * @param contig L'indice du contig.
+			 *
+			 * @return La longueur du contig.
+			**/
+			size_t length(size_t contig) const;
+
+			/**
+			 * @brief Donne les placements des séquences d'un contig.
+			 *
+			 * @param contig L'indice du contig.
+			 *
+			 * @return Les placements, dans l'ordre du contig.
+			**/
+			std::span<const Placement> layout(size_t contig) const;
+
+			/**
+			 * @brief Décode un contig à la suite d'une chaîne existante, sans allocation si sa capacité suffit.
+			 *
+			 * @param reads Les séquences référencées par les placements.
+			 * @param contig L'indice du contig.
+			 * @param out La chaîne à compléter.
+			**/
+			void decode(const ReadStore& reads, size_t contig, std::string& out) const;
+
+			/**
+			 * @brief Ne garde que les contigs marqués, en une passe et dans le même ordre.
+			 *
+			 * @param keep Pour chaque contig, 1 s'il est gardé.
+			**/
+			void retain(const std::vector<uint8_t>& keep);
+
+			/**
+			 * @brief Donne la mémoire occupée par les agencements.
+			 *
+			 * @return Le nombre d'octets alloués.
+			**/
+			size_t memory() const;
+	};
+
+#endif
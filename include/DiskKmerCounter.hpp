@@ -0,0 +1,222 @@
+#ifndef __DISKKMERCOUNTER__
+	#define __DISKKMERCOUNTER__
+
+	#include "config.hpp"
+	#include "ReadStore.hpp"
+	#include "ThreadPool.hpp"
+	#include <cstddef>
+	#include <cstdint>
+	#include <filesystem>
+	#include <fstream>
+	#include <ios>
+	#include <string>
+	#include <string_view>
+	#include <vector>
+
+	/**
+	 * @brief Comptage des k-mers (k ⩽ 32) hors mémoire : les reads sont découpés en super-k-mers selon leur minimiseur,
+	 * écrits dans des fichiers de partition sur le disque, puis chaque partition est comptée à part en mémoire.
+	 *
+	 * Un super-k-mer regroupe les k-mers consécutifs d'un read partageant le même minimiseur : toutes les occurrences
+	 * d'un k-mer tombent dans la même partition, dont la table seule tient en mémoire. Une partition dépassant encore
+	 * le budget de mémoire (nombre de partitions plafonné, k-mers mal répartis) est relue en plusieurs passes, chacune ne
+	 * comptant qu'une tranche de ses k-mers. Les k-mers contenant une base N sont écrits en clair dans un fichier à part
+	 * et comptés de même par tranches.
+	 *
+	 * Le budget de mémoire s'applique à chacune des deux phases : à l'écriture, les tampons des partitions se le partagent ;
+	 * au comptage, une fois ces tampons libérés, il couvre un bloc relu, la table vide d'une partition et ses k-mers (estimés
+	 * à BYTES_PER_KMER octets chacun). Il ne peut pas être inférieur à min_memory().
+	 *
+	 * Les erreurs du système de fichiers sont fatales : elles lèvent une std::runtime_error.
+	**/
+	class DiskKmerCounter {
+		private:
+			// Longueur maximale des minimiseurs (ramenée à k si k est plus petit)
+			static constexpr int MINIMIZER_LENGTH = 11;
+
+			// Taille maximale d'un tampon d'écriture ou d'un bloc relu, en octets
+			static constexpr size_t MAX_BUFFER_SIZE = 1 << 16;
+
+			// Taille minimale du tampon d'écriture de chaque partition, en octets : elle dépasse celle d'un super-k-mer écrit
+			// et celle d'un k-mer contenant une base N
+			static constexpr size_t MIN_WRITE_SIZE = 1 << 8;
+
+			// Taille minimale d'un bloc relu depuis un fichier, en octets : elle dépasse celle d'un super-k-mer écrit (un octet
+			// de longueur, puis au plus 2k - m < 64 bases sur 2 bits)
+			static constexpr size_t MIN_READ_SIZE = 1 << 12;
+
+			// Nombre maximal de partitions (fichiers ouverts en même temps)
+			static constexpr uint64_t MAX_PARTITIONS = 256;
+
+			// Nombre minimal de cases initiales de la table de chaque partition de PackedKmerSet
+			static constexpr size_t MIN_TABLE_SLOTS = 16;
+
+			// Mémoire estimée d'une occurrence de k-mer encodé dans la table d'une partition (code, nombre d'occurrences
+			// et cases libres), en octets
+			static constexpr uint64_t BYTES_PER_KMER = 16;
+
+			// Mémoire estimée d'une occurrence de k-mer contenant une base N, en plus de ses k caractères, en octets
+			static constexpr uint64_t BYTES_PER_N_KMER = 64;
+
+			// Mémoire estimée du filtre de Bloom par occurrence de k-mer (8 bits), en octets
+			static constexpr uint64_t BYTES_PER_FILTERED_KMER = 1;
+
+			// Mémoire estimée du comptage d'un octet relu depuis une partition (octet lu, bases décodées, vues des super-k-mers
+			// et tampons des k-mers encodés répartis entre les threads), en octets
+			static constexpr uint64_t BYTES_PER_READ_BYTE = 80;
+
+			int k;
+			int m;
+			size_t max_mem;
+
+			// Taille des tampons d'écriture et des blocs relus depuis les fichiers, budget restant aux tables une fois ces blocs
+			// comptés, et nombre initial de cases des tables, déduit de ce budget
+			size_t write_size;
+			size_t read_size;
+			uint64_t table_mem;
+			size_t initial_slots;
+			std::filesystem::path directory{};
+			std::vector<std::ofstream> files{};
+			std::vector<std::vector<uint8_t>> buffers{};
+			std::vector<uint64_t> kmers{};
+
+			// Fichier des k-mers contenant une base N, écrits en clair
+			std::ofstream n_file{};
+			std::string n_buffer{};
+			uint64_t n_kmers = 0;
+
+			/**
+			 * @brief Donne le chemin du fichier d'une partition.
+			 *
+			 * @param partition L'indice de la partition.
+			 *
+			 * @return Le chemin du fichier.
+			**/
+			std::filesystem::path path(size_t partition) const;
+
+			/**
+			 * @brief Donne le chemin du fichier des k-mers contenant une base N.
+			 *
+			 * @return Le chemin du fichier.
+			**/
+			std::filesystem::path n_path() const;
+
+			/**
+			 * @brief Vérifie l'état d'un flux de fichier après une opération.
+			 *
+			 * @param stream Le flux à vérifier.
+			 * @param action L'opération réalisée, pour le message d'erreur.
+			 * @param file Le chemin du fichier.
+			**/
+			static void check(const std::ios& stream, const std::string& action, const std::filesystem::path& file);
+
+			/**
+			 * @brief Donne le nombre de passes nécessaires pour compter un ensemble de k-mers dans le budget de mémoire des tables.
+			 *
+			 * Chaque passe crée une table vide de initial_slots cases par partition, dont la mémoire est retirée du budget.
+			 *
+			 * @param bytes La mémoire estimée des k-mers de la table en une seule passe, en octets.
+			 *
+			 * @return Le nombre de passes, au moins 1.
+			**/
+			uint64_t passes(uint64_t bytes) const;
+
+			/**
+			 * @brief Ajoute un super-k-mer au tampon de sa partition : sa longueur sur un octet, puis ses bases sur 2 bits.
+			 *
+			 * @param partition L'indice de la partition.
+			 * @param super_kmer Le super-k-mer, sans base N.
+			**/
+			void write(size_t partition, std::string_view super_kmer);
+
+			/**
+			 * @brief Écrit le tampon d'une partition dans son fichier.
+			 *
+			 * @param partition L'indice de la partition.
+			**/
+			void flush(size_t partition);
+
+			/**
+			 * @brief Écrit le tampon des k-mers contenant une base N dans son fichier.
+			**/
+			void flush_n();
+
+			/**
+			 * @brief Compte les k-mers contenant une base N par tranches tenant dans le budget de mémoire.
+			 *
+			 * @param min_count Le nombre minimal d'occurrences d'un k-mer gardé.
+			 * @param histogram Le spectre des k-mers à compléter.
+			 * @param reads Le stockage compacté à compléter avec les k-mers solides.
+			**/
+			void count_n_kmers(uint32_t min_count, std::vector<uint64_t>& histogram, ReadStore& reads);
+
+		public:
+			/**
+			 * @brief Crée les fichiers de partition dans un nouveau répertoire temporaire, accessible au seul utilisateur.
+			 *
+			 * Au comptage, le budget de mémoire est partagé entre les blocs relus depuis les fichiers, de taille fixe, et la table
+			 * d'une partition : le nombre de partitions est choisi pour que cette table tienne dans le reste du budget, dans la
+			 * limite de MAX_PARTITIONS. À l'écriture, les tampons des partitions et celui des k-mers contenant une base N se
+			 * partagent le budget.
+			 *
+			 * @param k La longueur des k-mers, au plus 32.
+			 * @param expected_kmers Le nombre estimé d'occurrences de k-mers.
+			 * @param max_mem Le budget de mémoire du comptage, en octets, au moins min_memory() (sinon une std::invalid_argument
+			 * est levée).
+			 *
+			 * @return Une instance DiskKmerCounter.
+			**/
+			DiskKmerCounter(int k, uint64_t expected_kmers, size_t max_mem);
+
+			/**
+			 * @brief Supprime les fichiers de partition.
+			**/
+			~DiskKmerCounter();
+
+			DiskKmerCounter(const DiskKmerCounter&) = delete;
+			DiskKmerCounter& operator=(const DiskKmerCounter&) = delete;
+
+			/**
+			 * @brief Découpe une séquence en super-k-mers et les écrit dans leurs partitions.
+			 *
+			 * @param sequence La séquence à k-mériser.
+			 *
+			 * @return Le nombre de k-mers générés à partir de la séquence.
+			**/
+			size_t add_kmers(std::string_view sequence);
+
+			/**
+			 * @brief Compte les k-mers de chaque partition l'une après l'autre et garde les k-mers solides.
+			 *
+			 * Chaque partition est relue par blocs de taille fixe, comptée en parallèle dans une table en mémoire (avec un filtre
+			 * de Bloom si demandé), en autant de passes que son nombre de k-mers l'impose, puis sa table et son fichier sont
+			 * libérés avant de passer à la suivante. Les tampons d'écriture sont libérés avant la première partition : seuls un
+			 * bloc et une table sont alors en mémoire, la table ne restant dans le budget qu'à l'estimation BYTES_PER_KMER près.
+			 *
+			 * @param min_count Le nombre minimal d'occurrences d'un k-mer gardé.
+			 * @param bloom_filter Note la première occurrence des k-mers dans un filtre de Bloom (si min_count ⩾ 2).
+			 * @param max_count Le nombre d'occurrences à partir duquel les k-mers sont regroupés dans la dernière case du spectre.
+			 * @param pool Le groupe de threads.
+			 * @param reads Le stockage compacté à compléter avec les k-mers solides.
+			 *
+			 * @return Le spectre des k-mers : le nombre de k-mers distincts par nombre d'occurrences, de 0 à max_count.
+			**/
+			std::vector<uint64_t> count(uint32_t min_count, bool bloom_filter, size_t max_count, ThreadPool& pool, ReadStore& reads);
+
+			/**
+			 * @brief Donne le plus petit budget de mémoire accepté : un bloc relu de taille minimale, la table vide d'une partition
+			 * avec le nombre minimal de cases, et autant pour ses k-mers.
+			 *
+			 * @return Le budget minimal, en octets.
+			**/
+			static size_t min_memory();
+
+			/**
+			 * @brief Donne le nombre de partitions.
+			 *
+			 * @return Le nombre de partitions.
+			**/
+			size_t size() const;
+	};
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef __FMINDEX__
+	#define __FMINDEX__
+
+	#include "config.hpp"
+	#include "ReadStore.hpp"
+	#include <array>
+	#include <cstddef>
+	#include <cstdint>
+	#include <vector>
+
+	class FMIndex {
+		private:
+			static const int SIGMA = 7;
+
+			const ReadStore& reads;
+			std::vector<uint8_t> bwt{};
+			std::vector<uint64_t> occurrences{};
+			std::array<uint64_t, SIGMA + 1> counts{};
+			std::vector<int32_t> separator_reads{};
+			std::vector<int64_t> read_ranks{};
+
+			/**
+			 * @brief Compte les occurrences d'un symbole dans la BWT avant une position donnée.
+			 *
+			 * @param symbol Le symbole à compter.
+			 * @param pos La position (exclue) jusqu'à laquelle compter.
+			 *
+			 * @return Le nombre d'occurrences du symbole dans bwt[0, pos).
+			**/
+			uint64_t occ(uint8_t symbol, uint64_t pos) const;
+
+			/**
+			 * @brief Cherche une séquence entière par recherche arrière.
+			 *
+			 * @param id L'identifiant de la séquence recherchée.
+			 * @param low La première ligne de l'intervalle des occurrences.
+			 * @param high La ligne suivant la dernière de l'intervalle des occurrences.
+			 *
+			 * @return true si la séquence apparaît dans le texte indexé.
+			**/
+			bool search(size_t id, uint64_t& low, uint64_t& high) const;
+
+		public:
+			/**
+			 * @brief Construit le tableau des suffixes et l'index FM du texte $s1$s2...$sn# formé des séquences données.
+			 *
+			 * @param reads Le stockage des séquences.
+			 * @param nodes Les identifiants des séquences à indexer (les successeurs possibles), sans doublon.
+			 *
+			 * @return Une instance FMIndex.
+			**/
+			FMIndex(const ReadStore& reads, const std::vector<int32_t>& nodes);
+
+			/**
+			 * @brief Cherche le meilleur successeur d'une séquence par recherche arrière de ses suffixes.
+			 *
+			 * À chaque extension, les lignes commençant par un séparateur donnent les séquences dont le préfixe est égal
+			 * au suffixe courant : le dernier intervalle non vide donne le plus long chevauchement.
+			 *
+			 * @param id L'identifiant de la séquence de référence.
+			 * @param min_overlap La longueur minimale d'un chevauchement : les séparateurs ne sont comptés qu'à partir de cette longueur.
+			 *
+			 * @return L'identifiant du meilleur successeur (le premier en cas d'égalité, -1 si aucun chevauchement n'atteint le minimum) et le score associé.
+			**/
+			Overlap best_overlap(size_t id, int min_overlap = 1) const;
+
+			/**
+			 * @brief Indique si une séquence apparaît dans une séquence indexée plus longue, ou si une copie identique d'identifiant
+			 * plus petit est indexée, par recherche arrière de la séquence entière.
+			 *
+			 * Une occurrence ne peut pas chevaucher un séparateur : une occurrence qui ne suit pas un séparateur se trouve dans
+			 * une séquence plus longue, et les autres sont des préfixes des séquences indexées. Une seule copie de chaque groupe
+			 * de séquences identiques n'est donc pas contenue. Le coût est proportionnel à la longueur de la séquence
+			 * (plus le nombre de ses copies identiques).
+			 *
+			 * @param id L'identifiant de la séquence recherchée.
+			 *
+			 * @return true si la séquence est contenue dans une séquence plus longue ou si elle n'est pas la première de ses copies.
+			**/
+			bool is_contained(size_t id) const;
+
+			/**
+			 * @brief Donne une séquence indexée contenant une séquence : plus longue, ou copie identique d'identifiant plus petit.
+			 *
+			 * Depuis une occurrence qui ne suit pas un séparateur, le texte est remonté (LF) jusqu'au séparateur de la séquence
+			 * qui la contient : le coût est proportionnel à la longueur de la séquence cherchée plus celle de son contenant.
+			 *
+			 * @param id L'identifiant de la séquence recherchée.
+			 *
+			 * @return L'identifiant d'une séquence contenant la séquence, -1 si elle n'est contenue dans aucune (comme is_contained).
+			**/
+			int32_t container(size_t id) const;
+	};
+
+#endif
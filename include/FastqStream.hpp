@@ -0,0 +1,50 @@
+#ifndef __FASTQSTREAM__
+	#define __FASTQSTREAM__
+
+	#include <cstddef>
+	#include <fstream>
+	#include <string>
+	#include <string_view>
+	#include <vector>
+
+	class FastqStream {
+		private:
+			std::ifstream fastq;
+			std::vector<char> buffer{};
+			std::size_t start = 0;
+			std::size_t filled = 0;
+			std::size_t line_idx = 0;
+			bool eof = false;
+
+		public:
+			/**
+			 * @brief Ouvre un fichier FASTQ pour le lire par blocs de taille fixe.
+			 *
+			 * @param filename Le nom du fichier FASTQ.
+			 * @param buffer_size La taille du tampon de lecture, en octets.
+			 *
+			 * @return Une instance FastqStream.
+			**/
+			FastqStream(const std::string& filename, std::size_t buffer_size);
+
+			/**
+			 * @brief Indique si le fichier a été ouvert avec succès.
+			 *
+			 * @return true si le fichier est ouvert, false sinon.
+			**/
+			bool is_open() const;
+
+			/**
+			 * @brief Lit le bloc suivant et extrait les séquences des enregistrements complets qu'il contient.
+			 *
+			 * Un enregistrement coupé par la fin du bloc est conservé et complété au bloc suivant.
+			 * Le tampon n'est agrandi que si une seule ligne dépasse sa taille.
+			 *
+			 * @param batch La liste à remplir avec des vues sur les séquences, valides jusqu'au prochain appel.
+			 *
+			 * @return false lorsque tout le fichier a été lu, true sinon.
+			**/
+			bool next_batch(std::vector<std::string_view>& batch);
+	};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef __MAPPEDFASTQ__
+	#define __MAPPEDFASTQ__
+
+	#include <cstddef>
+	#include <string>
+	#include <string_view>
+	#include <vector>
+
+	class MappedFastq {
+		private:
+			const char* data = nullptr;
+			std::size_t size = 0;
+			std::vector<std::string_view> sequences{};
+
+		public:
+			/**
+			 * @brief Projette un fichier FASTQ en mémoire (mmap) et repère les séquences sans les copier.
+			 *
+			 * @param filename Le nom du fichier FASTQ.
+			 *
+			 * @return Une instance MappedFastq, vide si le fichier n'a pas pu être projeté.
+			**/
+			MappedFastq(const std::string& filename);
+
+			/**
+			 * @brief Libère la projection du fichier. Les vues rendues par get_sequences deviennent invalides.
+			**/
+			~MappedFastq();
+
+			MappedFastq(const MappedFastq&) = delete;
+			MappedFastq& operator=(const MappedFastq&) = delete;
+
+			/**
+			 * @brief Indique si le fichier a été projeté avec succès.
+			 *
+			 * @return true si le fichier est projeté, false sinon.
+			**/
+			bool is_open() const;
+
+			/**
+			 * @brief Donne accès aux séquences du fichier, sous forme de vues sur la projection.
+			 *
+			 * @return Une liste de vues non propriétaires sur les lignes de séquence.
+			**/
+			const std::vector<std::string_view>& get_sequences() const;
+	};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef __MINIMIZERINDEX__
+	#define __MINIMIZERINDEX__
+
+	#include "config.hpp"
+	#include "ReadStore.hpp"
+	#include <cstddef>
+	#include <cstdint>
+	#include <utility>
+	#include <vector>
+
+	class MinimizerIndex {
+		public:
+			// Longueur des k-mers et nombre de k-mers consécutifs d'une fenêtre, par défaut
+			static constexpr int DEFAULT_K = 15;
+			static constexpr int DEFAULT_W = 10;
+
+		private:
+			// Un minimiseur plus fréquent (répétition) n'est pas utilisé comme graine
+			static const size_t MAX_OCCURRENCES = 1000;
+
+			const ReadStore& reads;
+			int k;
+			int w;
+			int min_seeds;
+			std::vector<uint64_t> keys{};
+			std::vector<int32_t> ids{};
+			std::vector<uint32_t> positions{};
+			std::vector<uint64_t> directory{};
+			int shift = 64;
+
+			/**
+			 * @brief Calcule les (w,k)-minimiseurs d'une séquence : le k-mer de plus petite empreinte de chaque fenêtre de w k-mers.
+			 *
+			 * Une séquence plus courte qu'une fenêtre garde le minimiseur de l'ensemble de ses k-mers.
+			 *
+			 * @param id L'identifiant de la séquence.
+			 * @param minimizers Le tableau à remplir avec l'empreinte et la position de chaque minimiseur.
+			**/
+			void minimizers(size_t id, std::vector<std::pair<uint64_t, uint32_t>>& minimizers) const;
+
+		public:
+			/**
+			 * @brief Indexe les minimiseurs des séquences données, regroupés par empreinte.
+			 *
+			 * @param reads Le stockage des séquences.
+			 * @param nodes Les identifiants des séquences à indexer (les successeurs possibles), sans doublon.
+			 * @param k La longueur des k-mers, de 1 à 31.
+			 * @param w Le nombre de k-mers consécutifs d'une fenêtre.
+			 * @param min_seeds Le nombre minimal de minimiseurs partagés sur une même diagonale pour vérifier un candidat,
+			 * 0 pour le déduire de la longueur minimale des chevauchements.
+			 *
+			 * @return Une instance MinimizerIndex.
+			**/
+			MinimizerIndex(const ReadStore& reads, const std::vector<int32_t>& nodes, int k = DEFAULT_K, int w = DEFAULT_W, int min_seeds = 0);
+
+			/**
+			 * @brief Cherche le meilleur successeur d'une séquence parmi les candidats partageant ses minimiseurs sur une même diagonale.
+			 *
+			 * Chaque diagonale donne la longueur du chevauchement, vérifiée base par base, de la plus longue à la plus courte.
+			 * Un chevauchement de L bases contient (L - k + 1) / w fenêtres disjointes, donc autant de minimiseurs communs
+			 * sur sa diagonale : par défaut, c'est le nombre de graines exigé pour la longueur minimale, ce qui n'écarte aucun
+			 * chevauchement assez long. Seuls les chevauchements de moins de k + w - 1 bases (sans fenêtre entière) et ceux
+			 * dont les graines sont trop fréquentes peuvent être manqués.
+			 *
+			 * @param id L'identifiant de la séquence de référence.
+			 * @param min_overlap La longueur minimale d'un chevauchement.
+			 *
+			 * @return L'identifiant du meilleur successeur (le premier en cas d'égalité, -1 si aucun chevauchement n'est trouvé) et le score associé.
+			**/
+			Overlap best_overlap(size_t id, int min_overlap = 1) const;
+	};
+
+#endif
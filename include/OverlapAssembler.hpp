@@ -2,17 +2,41 @@
 	#define __OVERLAPASSEMBLER__
 
 	#include "config.hpp"
+	#include "ReadStore.hpp"
+	#include "OverlapGraph.hpp"
+	#include "ContigLayouts.hpp"
+	#include "ThreadPool.hpp"
+	#include "MinimizerIndex.hpp"
 	#include <vector>
-	#include <unordered_map>
 	#include <string>
+	#include <cstdint>
+	#include <cstddef>
 
 	class OverlapAssembler {
 		private:
 			int k;
-			std::vector<std::string> sequences{};
-			std::unordered_map<std::string, std::vector<std::string>> overlap_graph{};
-			std::vector<std::string> trash{};
-			std::vector<std::string> contigs{};
+			ReadStore reads{};
+			OverlapGraph overlap_graph{};
+			std::vector<int32_t> trash{};
+			std::vector<int32_t> nodes{};
+			ContigLayouts contigs{};
+			ThreadPool pool;
+
+			/**
+			 * @brief Regroupe les séquences identiques, par hachage des séquences compactées.
+			 *
+			 * @return Pour chaque séquence, l'identifiant de sa première occurrence (elle-même si c'est la première).
+			**/
+			std::vector<int32_t> first_occurrences() const;
+
+			/**
+			 * @brief Ajuste le seuil à la longueur des k-mers, s'ils sont utilisés et plus courts que le seuil.
+			 *
+			 * @param seuil Le seuil demandé.
+			 *
+			 * @return Le seuil à appliquer.
+			**/
+			int adjust_seuil(int seuil) const;
 
 		public:
 			/**
@@ -20,41 +44,82 @@
 			 *
 			 * @param filename Le nom du fichier FASTQ.
 			 * @param k La longueur des k-mers à utiliser, si spécifiée.
+			 * @param buffer_size La taille du tampon pour une lecture en flux, 0 pour projeter le fichier entier.
+			 * @param threads Le nombre de threads à utiliser, 0 pour le nombre de cœurs disponibles.
+			 * @param min_kmer_count Le nombre minimal d'occurrences d'un k-mer pour en faire un nœud, les plus rares venant d'erreurs de séquençage.
+			 * @param max_mem Le budget de mémoire du comptage des k-mers (k ⩽ 32), en octets : s'il est donné, les k-mers sont comptés
+			 * partition par partition depuis le disque. 0 pour tout compter en mémoire.
+			 * @param bloom_filter Note la première occurrence des k-mers (k ⩽ 32) dans un filtre de Bloom quand au moins 2 occurrences
+			 * sont demandées : moins de mémoire, mais de rares k-mers vus une fois (faux positifs) sont gardés et le nombre de k-mers
+			 * vus une fois n'est qu'estimé.
 			 * 
 			 * @return Une instance BrutFoceAssembler.
 			**/
-			OverlapAssembler(const std::string& filename, int k = -1);
+			OverlapAssembler(const std::string& filename, int k = -1, std::size_t buffer_size = 0, std::size_t threads = 1, uint32_t min_kmer_count = 1, std::size_t max_mem = 0, bool bloom_filter = false);
+
+			/**
+			 * @brief Retire, avant la construction du graphe, les séquences en double et celles contenues dans une autre séquence.
+			 *
+			 * Chaque séquence distincte est cherchée en entier, en parallèle, dans un index FM des séquences distinctes, qui nomme
+			 * les séquences contenues dans une séquence plus longue. Les séquences maximales sont gardées pour MakeGraph, qui en fait
+			 * ses nœuds sans regrouper à nouveau les doublons.
+			**/
+			void RemoveContainedReads();
 
 			/**
 			 * @brief Crée le graphe de chevauchement à partir des séquences stockées dans l'assembleur.
+			 *
+			 * Les chevauchements plus courts que le seuil ne sont pas cherchés : les séquences sans chevauchement suffisant, dont celles
+			 * plus courtes que le seuil (qui ne sont pas indexées), vont directement dans la corbeille, ce qui rend CleanGraph inutile.
+			 *
+			 * @param engine Le moteur de chevauchement : "hash" (index des empreintes des préfixes), "fm" (index FM), "minimizer" (graines de minimiseurs, pour les reads longs) ou "brute" (toutes les paires).
+			 * @param seuil Le score de chevauchement minimum pour garder un nœud dans le graphe, 0 pour garder tous les nœuds.
+			 * @param minimizer_k La longueur des k-mers des minimiseurs (moteur "minimizer").
+			 * @param minimizer_w Le nombre de k-mers d'une fenêtre des minimiseurs (moteur "minimizer").
+			 * @param min_seeds Le nombre minimal de minimiseurs partagés sur une même diagonale pour vérifier un candidat (moteur "minimizer"),
+			 * 0 pour le déduire du seuil sans perdre de chevauchement.
 			**/
-			void MakeGraph();
+			void MakeGraph(const std::string& engine = "hash", int seuil = 0, int minimizer_k = MinimizerIndex::DEFAULT_K, int minimizer_w = MinimizerIndex::DEFAULT_W, int min_seeds = 0);
 
 			/**
 			 * @brief Nettoie le graphe de chevauchement en supprimant les séquences ayant un score de chevauchement inférieur au seuil.
 			 *
+			 * Les séquences supprimées s'ajoutent à la corbeille. Inutile si le seuil a déjà été appliqué par MakeGraph.
+			 *
 			 * @param seuil Le seuil à partir duquel les séquences sont considérées comme "inutiles" et sont supprimées.
 			**/
 			void CleanGraph(int seuil);
 
 			/**
-			 * @brief Recherche le meilleur nœud dans le graphe de chevauchement basé sur la longueur du chemin.
+			 * @brief Recherche le meilleur nœud dans le graphe de chevauchement basé sur la longueur du chemin (calculée en temps linéaire).
 			 *
 			 * @param overlap_graph Le graphe de chevauchement.
 			 * 
-			 * @return Une liste représentant le meilleur nœud trouvé, avec [seq1, seq2, score].
+			 * @return L'identifiant du meilleur nœud trouvé (à défaut, le premier nœud restant), -1 si le graphe est vide.
 			**/
-			std::vector<std::string> FindBestNode(const std::unordered_map<std::string, std::vector<std::string>>& overlap_graph);
+			int32_t FindBestNode(const OverlapGraph& overlap_graph);
 
 			/**
-			 * @brief Assemble les contigs à partir du graphe de chevauchement.
+			 * @brief Assemble les contigs à partir du graphe de chevauchement, qui est consommé puis libéré.
+			 *
+			 * Les composantes faiblement connexes du graphe sont assemblées en parallèle, puis les contigs
+			 * sont rassemblés dans l'ordre qu'aurait produit un assemblage séquentiel. Seul l'agencement
+			 * des séquences de chaque contig est conservé, ses bases ne sont décodées qu'à la sauvegarde.
 			**/
 			void AssembleContigs();
 
 			/**
-			 * @brief les séquences contenues dans d'autres séquences de la liste donnée.
+			 * @brief Retire les séquences contenues dans d'autres séquences, parmi les contigs et la corbeille.
+			 *
+			 * Chaque séquence est cherchée en entier dans un index FM de toutes les séquences, en temps proportionnel
+			 * à sa longueur, ou bien toutes les séquences passent une fois dans un automate d'Aho-Corasick construit sur les seules
+			 * séquences courtes (corbeille et contigs d'au plus deux reads), les contigs longs étant alors tous gardés.
+			 * Les séquences restantes sont ensuite compactées en une passe.
+			 *
+			 * @param release_reads Libère les séquences d'entrée dès que les contigs sont compactés sur 2 bits, puis ne garde que les contigs restants.
+			 * @param engine Le moteur de recherche : "fm" (index FM) ou "ac" (automate d'Aho-Corasick).
 			**/
-			void remove_contained_sequences();
+			void remove_contained_sequences(bool release_reads = false, const std::string& engine = "fm");
 
 			/**
 			 * @brief Enregistre les contigs dans un fichier au format FASTA, en excluant ceux en dessous d'une longueur minimale.
@@ -0,0 +1,28 @@
+#ifndef __OVERLAPGRAPH__
+	#define __OVERLAPGRAPH__
+
+	#include <cstddef>
+	#include <cstdint>
+	#include <vector>
+
+	/**
+	 * @brief Graphe de chevauchement indexé par identifiant de séquence, stocké en tableaux parallèles.
+	 *
+	 * Chaque nœud a au plus un successeur : le tableau des successeurs tient lieu de table d'arêtes (CSR)
+	 * dont les décalages sont implicites (un emplacement par nœud, -1 s'il n'y a pas d'arête).
+	**/
+	struct OverlapGraph {
+		// Successeur de chaque nœud, -1 s'il n'en a pas
+		std::vector<int32_t> successors{};
+
+		// Longueur du chevauchement entre chaque nœud et son successeur
+		std::vector<int32_t> scores{};
+
+		// Présence de chaque nœud dans le graphe
+		std::vector<uint8_t> present{};
+
+		// Nombre de nœuds présents
+		size_t size = 0;
+	};
+
+#endif
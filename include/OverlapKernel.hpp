@@ -0,0 +1,29 @@
+#ifndef __OVERLAPKERNEL__
+	#define __OVERLAPKERNEL__
+
+	#include <cstddef>
+	#include <cstdint>
+
+	/**
+	 * @brief Compare deux fragments de bases compactées sur 2 bits d'un même tampon, sans allocation.
+	 *
+	 * Les bases sont comparées 128 par 128 (AVX2, 32 octets), 64 par 64 (SSE4.2, 16 octets) ou 32 par 32
+	 * (version scalaire, un mot de 64 bits), selon le processeur, les dernières bases par la version scalaire.
+	 *
+	 * @param words Le tampon des bases, 32 par mot, la première dans les bits de poids faible, suivies d'un mot de marge.
+	 * @param start1 La position de la première base du premier fragment dans le tampon.
+	 * @param start2 La position de la première base du deuxième fragment dans le tampon.
+	 * @param length La longueur des fragments.
+	 *
+	 * @return true si les bases des deux fragments sont identiques (les bases N, codées comme des A, ne sont pas distinguées).
+	**/
+	bool packed_equal(const uint64_t* words, uint64_t start1, uint64_t start2, size_t length);
+
+	/**
+	 * @brief Donne le nom du noyau de comparaison choisi pour le processeur courant.
+	 *
+	 * @return "avx2", "sse4.2" ou "scalaire".
+	**/
+	const char* overlap_kernel_name();
+
+#endif
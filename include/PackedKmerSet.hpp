@@ -0,0 +1,214 @@
+#ifndef __PACKEDKMERSET__
+	#define __PACKEDKMERSET__
+
+	#include "config.hpp"
+	#include "ReadStore.hpp"
+	#include "ThreadPool.hpp"
+	#include <cstddef>
+	#include <cstdint>
+	#include <span>
+	#include <string>
+	#include <string_view>
+	#include <vector>
+
+	/**
+	 * @brief Ensemble de k-mers uniques (k ⩽ 32) encodés sur 2 bits par base dans un entier de 64 bits, avec leur nombre d'occurrences.
+	 *
+	 * Les k-mers sont répartis selon les bits de poids fort de leur empreinte entre des partitions indépendantes, chacune
+	 * étant une table à adressage ouvert sans allocation par k-mer. Les k-mers contenant une base N, non représentables
+	 * sur 2 bits, sont gardés à part sous forme de chaînes.
+	 *
+	 * Si un filtre de Bloom est utilisé, la première occurrence d'un k-mer n'est notée que dans le filtre de sa partition :
+	 * le k-mer n'entre dans la table qu'à sa deuxième occurrence, et les k-mers vus une seule fois n'occupent aucune case.
+	**/
+	class PackedKmerSet {
+		private:
+			// Code d'une case vide : c'est aussi celui du 32-mer TTT…T, compté à part
+			static constexpr uint64_t EMPTY = ~uint64_t(0);
+
+			// Nombre de partitions, fixe pour que le rangement des k-mers ne dépende pas du nombre de threads
+			static constexpr int PARTITION_BITS = 6;
+
+			// Nombre de séquences lues par bloc lors de l'ajout en parallèle
+			static constexpr size_t CHUNK = 256;
+
+			// Taille du filtre de Bloom par occurrence de k-mer attendue, en bits, et nombre de bits marqués par k-mer,
+			// déduit de la taille (ln 2 × bits par k-mer, qui minimise les faux positifs : environ 2 % pour 8 bits)
+			static constexpr size_t FILTER_BITS_PER_KMER = 8;
+			static constexpr int FILTER_HASHES = (FILTER_BITS_PER_KMER * 693 + 500) / 1000;
+			static_assert(FILTER_HASHES >= 1 && 9 * FILTER_HASHES <= 64, "les bits marqués d'un bloc sont tirés d'une empreinte de 64 bits");
+
+			/**
+			 * @brief Table à adressage ouvert des k-mers d'une partition.
+			**/
+			struct Partition {
+				std::vector<uint64_t> slots;
+				std::vector<uint32_t> counts;
+				size_t size = 0;
+				uint32_t empty_count = 0;
+
+				// Filtre de Bloom par blocs de 512 bits (une ligne de cache), vide s'il n'est pas utilisé
+				std::vector<uint64_t> filter;
+				uint64_t first_sightings = 0;
+			};
+
+			int k;
+			std::vector<Partition> partitions{};
+			KmerCounts others{};
+
+			// Tranche des k-mers encodés comptée, les autres étant ignorés
+			size_t slice = 0;
+			size_t slices = 1;
+
+			/**
+			 * @brief Indique si un k-mer encodé appartient à la tranche comptée.
+			 *
+			 * @param code Le k-mer encodé.
+			 *
+			 * @return true si le k-mer est compté.
+			**/
+			bool in_slice(uint64_t code) const;
+
+			/**
+			 * @brief Donne la partition d'un k-mer encodé.
+			 *
+			 * @param code Le k-mer encodé.
+			 *
+			 * @return L'indice de la partition.
+			**/
+			static size_t partition_of(uint64_t code);
+
+			/**
+			 * @brief Note un k-mer encodé dans le filtre de Bloom de sa partition.
+			 *
+			 * @param partition La partition du k-mer.
+			 * @param code Le k-mer encodé.
+			 *
+			 * @return true si le k-mer était peut-être déjà noté, false s'il est vu pour la première fois.
+			**/
+			static bool test_and_set(Partition& partition, uint64_t code);
+
+			/**
+			 * @brief Compte une occurrence d'un k-mer encodé dans sa partition, en agrandissant la table si besoin.
+			 *
+			 * Avec un filtre de Bloom, une première occurrence n'est notée que dans le filtre, et un k-mer entrant dans la table
+			 * à sa deuxième occurrence y est compté deux fois.
+			 *
+			 * @param partition La partition du k-mer.
+			 * @param code Le k-mer encodé.
+			**/
+			static void insert(Partition& partition, uint64_t code);
+
+			/**
+			 * @brief Double la taille de la table d'une partition et y replace les k-mers.
+			 *
+			 * @param partition La partition à agrandir.
+			**/
+			static void grow(Partition& partition);
+
+			/**
+			 * @brief Compte une occurrence d'un k-mer contenant une base N.
+			 *
+			 * @param kmer Le k-mer.
+			**/
+			void insert_other(std::string_view kmer);
+
+		public:
+			// Nombre initial de cases de la table de chaque partition, par défaut
+			static constexpr size_t INITIAL_SLOTS = 1024;
+
+			/**
+			 * @brief Crée un ensemble vide de k-mers de longueur k.
+			 *
+			 * @param k La longueur des k-mers, au plus 32.
+			 * @param initial_slots Le nombre initial de cases de la table de chaque partition, une puissance de 2.
+			 *
+			 * @return Une instance PackedKmerSet.
+			**/
+			PackedKmerSet(int k, size_t initial_slots = INITIAL_SLOTS);
+
+			/**
+			 * @brief Donne la mémoire des tables vides de toutes les partitions, pour un nombre initial de cases donné.
+			 *
+			 * @param slots Le nombre de cases de la table de chaque partition.
+			 *
+			 * @return Le nombre d'octets alloués.
+			**/
+			static size_t table_memory(size_t slots);
+
+			/**
+			 * @brief Ajoute un filtre de Bloom à chaque partition, avant tout ajout de k-mers.
+			 *
+			 * @param expected_kmers Le nombre d'occurrences de k-mers attendu, qui fixe la taille des filtres.
+			**/
+			void use_filter(uint64_t expected_kmers);
+
+			/**
+			 * @brief Ne compte qu'une tranche des k-mers encodés, avant tout ajout de k-mers.
+			 *
+			 * Les tranches sont tirées d'une empreinte indépendante de la partition et de la case des k-mers : compter
+			 * chaque tranche à part, en relisant les mêmes séquences, borne la taille de la table d'un ensemble trop grand.
+			 *
+			 * @param slice L'indice de la tranche comptée.
+			 * @param slices Le nombre de tranches.
+			**/
+			void use_slice(size_t slice, size_t slices);
+
+			/**
+			 * @brief Ajoute tous les k-mers d'une séquence, chaque k-mer étant déduit du précédent par décalage.
+			 *
+			 * @param sequence La séquence à k-mériser.
+			 *
+			 * @return Le nombre de k-mers générés à partir de la séquence.
+			**/
+			size_t add_kmers(std::string_view sequence);
+
+			/**
+			 * @brief Ajoute tous les k-mers d'un lot de séquences en parallèle, sans verrou.
+			 *
+			 * Chaque bloc de séquences range ses k-mers par partition dans son propre tampon, puis chaque partition
+			 * est complétée par un seul thread à partir des tampons de tous les blocs, dans l'ordre des séquences :
+			 * le résultat est identique à celui de l'ajout séquence par séquence.
+			 *
+			 * @param sequences Les séquences à k-mériser.
+			 * @param pool Le groupe de threads.
+			 *
+			 * @return Le nombre de k-mers générés à partir des séquences.
+			**/
+			size_t add_kmers(std::span<const std::string_view> sequences, ThreadPool& pool);
+
+			/**
+			 * @brief Donne le nombre de k-mers uniques.
+			 *
+			 * @return Le nombre de k-mers uniques.
+			**/
+			size_t size() const;
+
+			/**
+			 * @brief Donne le spectre des k-mers : le nombre de k-mers distincts pour chaque nombre d'occurrences.
+			 *
+			 * Avec un filtre de Bloom, le nombre de k-mers vus une seule fois est estimé à partir des premières occurrences notées.
+			 *
+			 * @param max_count Le nombre d'occurrences à partir duquel les k-mers sont regroupés dans la dernière case.
+			 *
+			 * @return Le nombre de k-mers distincts par nombre d'occurrences, de 0 à max_count.
+			**/
+			std::vector<uint64_t> histogram(size_t max_count) const;
+
+			/**
+			 * @brief Ajoute les k-mers uniques assez fréquents à un stockage compacté, sans les décoder.
+			 *
+			 * @param reads Le stockage à compléter.
+			 * @param min_count Le nombre minimal d'occurrences d'un k-mer gardé (k-mer solide).
+			**/
+			void store(ReadStore& reads, uint32_t min_count = 1) const;
+
+			/**
+			 * @brief Donne la mémoire occupée par les tables des k-mers encodés et les filtres de Bloom.
+			 *
+			 * @return Le nombre d'octets alloués.
+			**/
+			size_t memory() const;
+	};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef __PREFIXINDEX__
+	#define __PREFIXINDEX__
+
+	#include "config.hpp"
+	#include "ReadStore.hpp"
+	#include <cstddef>
+	#include <cstdint>
+	#include <vector>
+
+	class PrefixIndex {
+		private:
+			const ReadStore& reads;
+			std::vector<uint64_t> keys{};
+			std::vector<int32_t> ids{};
+			std::vector<uint64_t> directory{};
+			std::vector<uint64_t> powers{};
+			int shift = 64;
+
+			/**
+			 * @brief Calcule la clé d'un fragment à partir de son empreinte et de sa longueur.
+			 *
+			 * @param fingerprint L'empreinte polynomiale du fragment.
+			 * @param length La longueur du fragment.
+			 *
+			 * @return La clé du fragment dans l'index.
+			**/
+			static uint64_t key(uint64_t fingerprint, size_t length);
+
+		public:
+			/**
+			 * @brief Indexe les empreintes de tous les préfixes des séquences données.
+			 *
+			 * @param reads Le stockage des séquences.
+			 * @param nodes Les identifiants des séquences à indexer (les successeurs possibles), sans doublon.
+			 *
+			 * @return Une instance PrefixIndex.
+			**/
+			PrefixIndex(const ReadStore& reads, const std::vector<int32_t>& nodes);
+
+			/**
+			 * @brief Cherche le meilleur successeur d'une séquence en sondant l'index avec ses suffixes, du plus long au plus court.
+			 *
+			 * Chaque candidat est vérifié base par base, le résultat est identique à celui de calculate_overlaps.
+			 *
+			 * @param id L'identifiant de la séquence de référence.
+			 * @param min_overlap La longueur minimale d'un chevauchement : les suffixes plus courts ne sont pas sondés.
+			 *
+			 * @return L'identifiant du meilleur successeur (le premier en cas d'égalité, -1 si aucun chevauchement n'atteint le minimum) et le score associé.
+			**/
+			Overlap best_overlap(size_t id, int min_overlap = 1) const;
+	};
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef __READSTORE__
+	#define __READSTORE__
+
+	#include <cstddef>
+	#include <cstdint>
+	#include <string>
+	#include <string_view>
+	#include <vector>
+
+	class ReadStore {
+		private:
+			std::vector<uint64_t> words{0};
+			std::vector<uint64_t> offsets{0};
+			std::vector<uint64_t> n_positions{};
+			std::vector<uint32_t> n_offsets{0};
+
+		public:
+			/**
+			 * @brief Encode une base sur 2 bits (A=0, C=1, G=2, T=3), toute autre base est une base N codée 0.
+			 *
+			 * @param base La base à encoder.
+			 *
+			 * @return Le code de la base.
+			**/
+			static uint64_t encode(char base);
+
+			/**
+			 * @brief Ajoute une séquence à la fin du tampon compacté.
+			 *
+			 * @param sequence La séquence à ajouter.
+			 *
+			 * @return L'identifiant de la séquence ajoutée.
+			**/
+			size_t add(std::string_view sequence);
+
+			/**
+			 * @brief Ajoute une séquence déjà encodée sur 2 bits (sans base N), sans la décoder.
+			 *
+			 * @param bases Les bases de la séquence, la première dans les bits de poids faible.
+			 * @param length La longueur de la séquence, au plus 32.
+			 *
+			 * @return L'identifiant de la séquence ajoutée.
+			**/
+			size_t add_packed(uint64_t bases, size_t length);
+
+			/**
+			 * @brief Donne le nombre de séquences stockées.
+			 *
+			 * @return Le nombre de séquences.
+			**/
+			size_t size() const;
+
+			/**
+			 * @brief Donne la longueur d'une séquence.
+			 *
+			 * @param id L'identifiant de la séquence.
+			 *
+			 * @return La longueur de la séquence.
+			**/
+			size_t length(size_t id) const;
+
+			/**
+			 * @brief Indique si une séquence contient des bases N.
+			 *
+			 * @param id L'identifiant de la séquence.
+			 *
+			 * @return true si la séquence contient au moins une base N.
+			**/
+			bool has_n(size_t id) const;
+
+			/**
+			 * @brief Décode une base d'une séquence.
+			 *
+			 * @param id L'identifiant de la séquence.
+			 * @param pos La position de la base dans la séquence.
+			 *
+			 * @return La base décodée ('A', 'C', 'G', 'T' ou 'N').
+			**/
+			char base(size_t id, size_t pos) const;
+
+			/**
+			 * @brief Extrait 32 bases consécutives d'une séquence, compactées sur 64 bits.
+			 *
+			 * @param id L'identifiant de la séquence.
+			 * @param pos La position de la première base. Les bases au-delà de la fin de la séquence sont quelconques.
+			 *
+			 * @return Les 32 bases, la première dans les bits de poids faible.
+			**/
+			uint64_t word(size_t id, size_t pos) const;
+
+			/**
+			 * @brief Compare deux fragments de séquences stockées.
+			 *
+			 * Les bases compactées sont comparées par le noyau choisi pour le processeur (jusqu'à 128 bases par comparaison
+			 * avec AVX2), puis les positions des bases N.
+			 *
+			 * @param id1 L'identifiant de la première séquence.
+			 * @param pos1 La position du fragment dans la première séquence.
+			 * @param id2 L'identifiant de la deuxième séquence.
+			 * @param pos2 La position du fragment dans la deuxième séquence.
+			 * @param length La longueur des fragments.
+			 *
+			 * @return true si les deux fragments sont identiques, bases N comprises.
+			**/
+			bool equal(size_t id1, size_t pos1, size_t id2, size_t pos2, size_t length) const;
+
+			/**
+			 * @brief Calcule une empreinte du contenu d'une séquence (les bases N sont vues comme des A).
+			 *
+			 * @param id L'identifiant de la séquence.
+			 *
+			 * @return L'empreinte de la séquence.
+			**/
+			uint64_t hash(size_t id) const;
+
+			/**
+			 * @brief Décode la fin d'une séquence à la suite d'une chaîne existante, sans allocation si sa capacité suffit.
+			 *
+			 * @param id L'identifiant de la séquence.
+			 * @param pos La position de la première base à décoder.
+			 * @param out La chaîne à compléter.
+			**/
+			void decode(size_t id, size_t pos, std::string& out) const;
+
+			/**
+			 * @brief Décode une séquence entière.
+			 *
+			 * @param id L'identifiant de la séquence.
+			 *
+			 * @return La séquence décodée.
+			**/
+			std::string get(size_t id) const;
+
+			/**
+			 * @brief Donne la mémoire occupée par le stockage.
+			 *
+			 * @return Le nombre d'octets alloués.
+			**/
+			size_t memory() const;
+	};
+
+#endif
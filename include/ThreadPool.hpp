@@ -0,0 +1,101 @@
+#ifndef __THREADPOOL__
+	#define __THREADPOOL__
+
+	#include <condition_variable>
+	#include <cstddef>
+	#include <deque>
+	#include <exception>
+	#include <functional>
+	#include <memory>
+	#include <mutex>
+	#include <thread>
+	#include <vector>
+
+	class ThreadPool {
+		private:
+			struct TaskQueue {
+				std::mutex mutex;
+				std::deque<std::function<void()>> tasks;
+			};
+
+			std::vector<std::unique_ptr<TaskQueue>> queues{};
+			std::vector<std::thread> workers{};
+			std::mutex state_mutex{};
+			std::condition_variable work_available{};
+			std::condition_variable work_done{};
+			size_t queued = 0;
+			size_t pending = 0;
+			size_t next_queue = 0;
+			bool stopping = false;
+			std::exception_ptr error{};
+
+			/**
+			 * @brief Récupère une tâche : d'abord à la fin de la file du thread, sinon au début de la file d'un autre thread.
+			 *
+			 * @param index L'indice du thread demandeur.
+			 * @param task La tâche récupérée.
+			 *
+			 * @return true si une tâche a été récupérée.
+			**/
+			bool pop_task(size_t index, std::function<void()>& task);
+
+			/**
+			 * @brief Boucle d'exécution d'un thread du groupe.
+			 *
+			 * @param index L'indice du thread.
+			**/
+			void worker_loop(size_t index);
+
+		public:
+			/**
+			 * @brief Démarre un groupe de threads avec une file de tâches par thread et vol de tâches entre files.
+			 *
+			 * @param threads Le nombre de threads, 0 pour le nombre de cœurs disponibles.
+			 *
+			 * @return Une instance ThreadPool.
+			**/
+			ThreadPool(size_t threads);
+
+			/**
+			 * @brief Termine les tâches en cours et arrête les threads.
+			**/
+			~ThreadPool();
+
+			ThreadPool(const ThreadPool&) = delete;
+			ThreadPool& operator=(const ThreadPool&) = delete;
+
+			/**
+			 * @brief Donne le nombre de threads du groupe.
+			 *
+			 * @return Le nombre de threads.
+			**/
+			size_t size() const;
+
+			/**
+			 * @brief Ajoute une tâche, répartie à tour de rôle entre les files des threads.
+			 *
+			 * @param task La tâche à exécuter.
+			**/
+			void submit(std::function<void()> task);
+
+			/**
+			 * @brief Attend la fin de toutes les tâches soumises.
+			 *
+			 * Si une tâche a levé une exception, la première est relancée une fois toutes les tâches terminées.
+			**/
+			void wait();
+
+			/**
+			 * @brief Découpe un intervalle en blocs traités en parallèle, puis attend la fin de tous les blocs.
+			 *
+			 * Une exception levée par un bloc est relancée après la fin de tous les blocs.
+			 *
+			 * @param begin Le début de l'intervalle.
+			 * @param end La fin (exclue) de l'intervalle.
+			 * @param chunk La taille des blocs.
+			 * @param body La fonction appelée sur chaque bloc [début, fin).
+			**/
+			void parallel_for(size_t begin, size_t end, size_t chunk, const std::function<void(size_t, size_t)>& body);
+	};
+
+#endif
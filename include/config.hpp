@@ -3,56 +3,127 @@
 
 	#include <vector>
 	#include <string>
+	#include <string_view>
 	#include <unordered_set>
+	#include <unordered_map>
+	#include <functional>
+	#include <cstddef>
+	#include <cstdint>
+	#include <span>
+	#include "ReadStore.hpp"
+
+	/**
+	 * @brief Meilleur chevauchement d'une séquence : identifiant du successeur (-1 si aucun) et longueur du chevauchement.
+	**/
+	struct Overlap {
+		int32_t id;
+		int32_t score;
+	};
+
+	/**
+	 * @brief Mélange un entier de 64 bits (finaliseur splitmix64) : tous les bits du résultat dépendent de tous ceux de l'entrée.
+	 *
+	 * Sert d'empreinte aux k-mers et m-mers encodés sur 2 bits par base, défini ici pour être développé dans les boucles
+	 * de k-mérisation.
+	 *
+	 * @param value L'entier à mélanger.
+	 *
+	 * @return L'empreinte de l'entier.
+	**/
+	inline uint64_t splitmix64(uint64_t value) {
+		value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+		return value ^ (value >> 31);
+	}
+
+	/**
+	 * @brief Fonction de hachage des k-mers acceptant des vues, pour chercher un k-mer sans construire de chaîne.
+	**/
+	struct KmerHash {
+		using is_transparent = void;
+		size_t operator()(std::string_view kmer) const;
+	};
+
+	/**
+	 * @brief Nombre d'occurrences de chaque k-mer unique, interrogeable avec des vues.
+	**/
+	typedef std::unordered_map<std::string, uint32_t, KmerHash, std::equal_to<>> KmerCounts;
 	
 	/**
-	 * @brief Lit un fichier FASTQ et extrait les séquences.
+	 * @brief Lit un fichier FASTQ par blocs de taille fixe et transmet chaque lot de séquences dès qu'il est lu.
 	 *
 	 * @param filename Le nom du fichier FASTQ.
-	 * 
-	 * @return Un vecteur des séquences extraites.
+	 * @param buffer_size La taille du tampon de lecture, en octets.
+	 * @param consumer La fonction appelée sur chaque lot, les vues ne sont valides que pendant l'appel.
 	**/
-	std::vector<std::string> read_fastq(const std::string& filename);
+	void stream_fastq(const std::string& filename, std::size_t buffer_size, const std::function<void(const std::vector<std::string_view>&)>& consumer);
 
 	/**
-	 * @brief Effectue la k-mérisation des séquences en générant tous les k-mers uniques.
+	 * @brief Estime le nombre d'occurrences de k-mers d'un fichier FASTQ lu en flux, dont le nombre de reads n'est pas connu d'avance.
+	 *
+	 * Le premier bloc du fichier donne la taille moyenne d'un enregistrement et le nombre moyen de k-mers d'un read :
+	 * l'estimation est le nombre d'enregistrements de cette taille dans le fichier, fois ce nombre moyen. Elle suppose le
+	 * premier bloc représentatif du fichier ; à défaut d'au moins deux reads dans ce bloc, chaque base occupant au moins
+	 * 2 octets du fichier (séquence et qualité), la moitié de sa taille borne le nombre de k-mers.
 	 *
-	 * @param sequences Une liste de séquences à k-mériser.
+	 * @param filename Le nom du fichier FASTQ.
+	 * @param buffer_size La taille du tampon de lecture, en octets.
 	 * @param k La longueur des k-mers.
-	 * 
-	 * @return Une liste de tous les k-mers uniques générés à partir des séquences.
+	 *
+	 * @return Le nombre d'occurrences de k-mers estimé, 0 si le fichier ne peut pas être lu.
 	**/
-	std::vector<std::string> kmerisation(const std::vector<std::string>& sequences, int k);
+	uint64_t estimate_kmers(const std::string& filename, std::size_t buffer_size, int k);
 
 	/**
-	 * @brief Concatène deux séquences en utilisant un score pour déterminer le point de départ de la deuxième séquence.
+	 * @brief Compte tous les k-mers d'une séquence dans une table de k-mers uniques.
 	 *
-	 * @param seq1 La première séquence.
-	 * @param seq2 La deuxième séquence.
-	 * @param score Le score pour déterminer le point de départ de la deuxième séquence.
+	 * Seuls les nouveaux k-mers sont alloués, les autres sont cherchés à partir d'une vue sur la séquence.
 	 *
-	 * @return La séquence résultante après la concaténation.
+	 * @param sequence La séquence à k-mériser.
+	 * @param k La longueur des k-mers.
+	 * @param kmer_counts La table des k-mers uniques et de leur nombre d'occurrences à compléter.
+	 * 
+	 * @return Le nombre de k-mers générés à partir de la séquence.
 	**/
-	std::string concat_sequences(const std::string& seq1, const std::string& seq2, int score);
+	size_t add_kmers(std::string_view sequence, int k, KmerCounts& kmer_counts);
 
 	/**
-	 * @brief Calcule la longueur du chevauchement maximal entre deux séquences.
+	 * @brief Affiche le spectre des k-mers : le nombre de k-mers distincts pour chaque nombre d'occurrences.
 	 *
-	 * @param seq1 La première séquence.
-	 * @param seq2 La deuxième séquence.
-	 * 
-	 * @return La longueur du chevauchement maximal entre les deux séquences.
+	 * @param histogram Le nombre de k-mers distincts par nombre d'occurrences, la dernière case regroupant les occurrences supérieures.
+	 * @param k La longueur des k-mers.
+	 * @param estimated_singletons Indique que le nombre de k-mers vus une seule fois n'est qu'une estimation (filtre de Bloom).
 	**/
-	int compute_overlap(const std::string& seq1, const std::string& seq2);
+	void print_kmer_spectrum(const std::vector<uint64_t>& histogram, int k, bool estimated_singletons = false);
 
 	/**
-	 * @brief Calcule le meilleur chevauchement et le score associé avec une séquence parmi une liste de séquences.
+	 * @brief Calcule la longueur du chevauchement maximal entre deux séquences compactées.
+	 *
+	 * Les longueurs candidates sont testées de la plus grande à la plus petite, chacune par le noyau vectorisé de ReadStore::equal,
+	 * sans allocation.
 	 *
-	 * @param seq1 La séquence de référence.
-	 * @param sequences Une liste de séquences avec lesquelles comparer la séquence de référence.
+	 * @param reads Le stockage des séquences.
+	 * @param id1 L'identifiant de la première séquence.
+	 * @param id2 L'identifiant de la deuxième séquence.
+	 * @param min_overlap La longueur minimale d'un chevauchement, les longueurs inférieures ne sont pas testées.
 	 * 
-	 * @return Une liste contenant le meilleur chevauchement et le score associé.
+	 * @return La longueur du chevauchement maximal entre les deux séquences, 0 s'il est plus court que le minimum.
+	**/
+	int compute_overlap(const ReadStore& reads, size_t id1, size_t id2, int min_overlap = 1);
+
+	/**
+	 * @brief Calcule le meilleur chevauchement d'un bloc de séquences compactées avec une liste de séquences compactées, par tuiles.
+	 *
+	 * Les candidats sont parcourus par tuiles tenant dans le cache, chaque tuile étant comparée à tout le bloc avant de passer
+	 * à la suivante. Seules les longueurs dépassant le meilleur score courant sont testées, et une séquence dont le score atteint
+	 * sa propre longueur (le maximum possible) n'est plus comparée. Le résultat est celui d'une comparaison de chaque séquence à tous les candidats, dans l'ordre.
+	 *
+	 * @param reads Le stockage des séquences.
+	 * @param queries Les identifiants des séquences de référence.
+	 * @param candidates Les identifiants des successeurs possibles, triés.
+	 * @param min_overlap La longueur minimale d'un chevauchement, les longueurs inférieures ne sont pas testées.
+	 * @param results Le meilleur successeur et le score associé de chaque séquence de référence.
 	**/
-	std::vector<std::string> calculate_overlap(const std::string& seq1, const std::vector<std::string>& sequences);
+	void calculate_overlaps(const ReadStore& reads, std::span<const int32_t> queries, const std::vector<int32_t>& candidates, int min_overlap, std::span<Overlap> results);
 
 #endif
\ No newline at end of file
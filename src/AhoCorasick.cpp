@@ -0,0 +1,132 @@
+#include "../include/AhoCorasick.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Symbole de la base N, les bases A, C, G et T gardant leur code sur 2 bits
+static const uint8_t N_SYMBOL = 4;
+
+void AhoCorasick::symbols(size_t id, std::vector<uint8_t>& symbols) const {
+	const size_t length = this->reads.length(id);
+	symbols.resize(length);
+
+	// Décoder les codes 32 par 32
+	for (size_t done = 0; done < length; done += 32) {
+		const size_t count = std::min<size_t>(32, length - done);
+		uint64_t bases = this->reads.word(id, done);
+		for (size_t i = 0; i < count; ++i) {
+			symbols[done + i] = bases & 3;
+			bases >>= 2;
+		}
+	}
+
+	// Rétablir les bases N, codées comme des A
+	if (this->reads.has_n(id)) {
+		for (size_t pos = 0; pos < length; ++pos) {
+			if (symbols[pos] == 0 && this->reads.base(id, pos) == 'N') {
+				symbols[pos] = N_SYMBOL;
+			}
+		}
+	}
+}
+
+AhoCorasick::AhoCorasick(const ReadStore& reads, const std::vector<int32_t>& patterns) : reads(reads) {
+	// Arbre des préfixes des motifs, la racine étant l'état 0
+	this->transitions.push_back({-1, -1, -1, -1, -1});
+	this->first_patterns.push_back(-1);
+	this->next_patterns.assign(reads.size(), -1);
+	std::vector<uint8_t> pattern;
+	for (int32_t id : patterns) {
+		this->symbols(id, pattern);
+		int32_t node = 0;
+		for (uint8_t symbol : pattern) {
+			if (this->transitions[node][symbol] == -1) {
+				this->transitions[node][symbol] = this->transitions.size();
+				this->transitions.push_back({-1, -1, -1, -1, -1});
+				this->first_patterns.push_back(-1);
+			}
+			node = this->transitions[node][symbol];
+		}
+
+		// Les copies identiques d'un motif partagent son état final
+		this->next_patterns[id] = this->first_patterns[node];
+		this->first_patterns[node] = id;
+	}
+
+	// Liens d'échec et de dictionnaire, en largeur d'abord
+	const size_t total = this->transitions.size();
+	std::vector<int32_t> failures(total, 0);
+	this->dictionary_links.assign(total, -1);
+	std::vector<int32_t> queue;
+	queue.reserve(total);
+	for (int symbol = 0; symbol < SIGMA; ++symbol) {
+		int32_t& child = this->transitions[0][symbol];
+		if (child == -1) {
+			child = 0;
+		} else {
+			queue.push_back(child);
+		}
+	}
+	for (size_t head = 0; head < queue.size(); ++head) {
+		const int32_t node = queue[head];
+		const int32_t failure = failures[node];
+
+		// Le lien de dictionnaire mène au plus proche état final le long des liens d'échec
+		this->dictionary_links[node] = (this->first_patterns[failure] != -1) ? failure : this->dictionary_links[failure];
+
+		// Compléter les transitions manquantes par celles du lien d'échec
+		for (int symbol = 0; symbol < SIGMA; ++symbol) {
+			int32_t& child = this->transitions[node][symbol];
+			if (child == -1) {
+				child = this->transitions[failure][symbol];
+			} else {
+				failures[child] = this->transitions[failure][symbol];
+				queue.push_back(child);
+			}
+		}
+	}
+
+	// Aucun motif n'est encore marqué
+	this->done.assign(total, 0);
+	this->containers.assign(reads.size(), -1);
+}
+
+void AhoCorasick::report(int32_t node, int32_t text) {
+	// Suivre les états finaux jusqu'au premier dont tous les motifs sont déjà marqués
+	thread_local std::vector<int32_t> chain;
+	chain.clear();
+	for (int32_t current = (this->first_patterns[node] != -1) ? node : this->dictionary_links[node]; current != -1 && !this->done[current]; current = this->dictionary_links[current]) {
+		chain.push_back(current);
+	}
+
+	// Marquer les motifs, puis les états entièrement marqués en partant de la fin de la chaîne
+	for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+		bool complete = true;
+		for (int32_t id = this->first_patterns[*it]; id != -1; id = this->next_patterns[id]) {
+			// Un texte de même longueur est une copie identique : seule la copie de plus petit identifiant est gardée
+			if (id != text && this->containers[id] == -1 && (this->reads.length(text) > this->reads.length(id) || text < id)) {
+				this->containers[id] = text;
+			}
+			complete = complete && this->containers[id] != -1;
+		}
+		const int32_t link = this->dictionary_links[*it];
+		this->done[*it] = complete && (link == -1 || this->done[link]);
+	}
+}
+
+void AhoCorasick::scan(size_t id) {
+	thread_local std::vector<uint8_t> text;
+	this->symbols(id, text);
+
+	// Le motif vide éventuel est reconnu avant la première base
+	int32_t node = 0;
+	this->report(node, id);
+	for (uint8_t symbol : text) {
+		node = this->transitions[node][symbol];
+		this->report(node, id);
+	}
+}
+
+int32_t AhoCorasick::container(size_t id) const {
+	return this->containers[id];
+}
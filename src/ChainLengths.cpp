@@ -0,0 +1,142 @@
+#include "../include/ChainLengths.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+ChainLengths::ChainLengths(const OverlapGraph& overlap_graph, const std::vector<int32_t>& nodes) : overlap_graph(overlap_graph), nodes(nodes) {
+	const int32_t total = this->nodes.size();
+	const std::vector<int32_t>& successors = overlap_graph.successors;
+	const std::vector<uint8_t>& present = overlap_graph.present;
+
+	// Indice local du successeur, qui n'est suivi que s'il est présent dans le graphe
+	auto next = [&](int32_t local) -> int32_t {
+		const int32_t successor = successors[this->nodes[local]];
+		return (successor != -1 && present[successor]) ? this->index(successor) : -1;
+	};
+
+	// États des nœuds : 0 non visité, 1 sur le chemin en cours, 2 calculé
+	this->lengths.assign(total, 0);
+	std::vector<uint8_t> state(total, 0);
+	std::vector<int32_t> position(total, 0);
+	std::vector<int32_t> path;
+
+	for (int32_t start = 0; start < total; ++start) {
+		if (state[start] != 0) {
+			continue;
+		}
+
+		// Suivre les successeurs jusqu'à un nœud déjà calculé, un nœud du chemin en cours (cycle) ou la fin
+		path.clear();
+		int32_t node = start;
+		while (node != -1 && state[node] == 0) {
+			state[node] = 1;
+			position[node] = path.size();
+			path.push_back(node);
+			node = next(node);
+		}
+
+		// Longueur du chemin qui suit le dernier nœud du chemin en cours
+		int32_t length = 0;
+		if (node != -1 && state[node] == 1) {
+			// Tous les nœuds du cycle ont la longueur du cycle
+			const int32_t cycle_start = position[node];
+			const int32_t cycle_length = path.size() - cycle_start;
+			for (size_t i = cycle_start; i < path.size(); ++i) {
+				this->lengths[path[i]] = cycle_length;
+				state[path[i]] = 2;
+			}
+			path.resize(cycle_start);
+			length = cycle_length;
+		} else if (node != -1) {
+			length = this->lengths[node];
+		}
+
+		// Remonter le chemin en cours
+		for (auto it = path.rbegin(); it != path.rend(); ++it) {
+			length++;
+			this->lengths[*it] = length;
+			state[*it] = 2;
+		}
+	}
+
+	// Table des prédécesseurs présents de chaque nœud (CSR, en indices locaux)
+	std::vector<int32_t> targets(total);
+	this->predecessor_offsets.assign(total + 1, 0);
+	for (int32_t node = 0; node < total; ++node) {
+		targets[node] = next(node);
+		if (targets[node] != -1) {
+			this->predecessor_offsets[targets[node] + 1]++;
+		}
+	}
+	for (int32_t node = 0; node < total; ++node) {
+		this->predecessor_offsets[node + 1] += this->predecessor_offsets[node];
+	}
+	this->predecessors.resize(this->predecessor_offsets[total]);
+	std::vector<int32_t> filled(this->predecessor_offsets.begin(), this->predecessor_offsets.end() - 1);
+	for (int32_t node = 0; node < total; ++node) {
+		if (targets[node] != -1) {
+			this->predecessors[filled[targets[node]]++] = node;
+		}
+	}
+
+	// File de priorité des nœuds : plus long chemin d'abord, puis plus petit identifiant
+	for (int32_t node = 0; node < total; ++node) {
+		this->candidates.emplace(this->score(node), -this->nodes[node]);
+	}
+}
+
+int32_t ChainLengths::index(int32_t node) const {
+	return std::lower_bound(this->nodes.begin(), this->nodes.end(), node) - this->nodes.begin();
+}
+
+int32_t ChainLengths::score(int32_t node) const {
+	return (this->overlap_graph.successors[this->nodes[node]] == -1) ? 0 : this->lengths[node];
+}
+
+int32_t ChainLengths::best_node() {
+	// Écarter les entrées périmées (nœud retiré ou longueur modifiée depuis)
+	while (!this->candidates.empty()) {
+		const auto& [length, negative_node] = this->candidates.top();
+		const int32_t node = -negative_node;
+		if (this->overlap_graph.present[node] && length == this->score(this->index(node))) {
+			return node;
+		}
+		this->candidates.pop();
+	}
+	return -1;
+}
+
+int32_t ChainLengths::length(int32_t node) const {
+	return this->score(this->index(node));
+}
+
+void ChainLengths::remove_chain(const std::vector<int32_t>& chain) {
+	std::vector<int32_t> stack;
+
+	for (int32_t removed_node : chain) {
+		// Les chemins qui rejoignent la chaîne à ce nœud perdent toute sa longueur
+		const int32_t removed = this->index(removed_node);
+		const int32_t delta = this->lengths[removed];
+
+		// Parcourir les prédécesseurs restants, puis leurs propres prédécesseurs
+		stack.clear();
+		for (int32_t i = this->predecessor_offsets[removed]; i < this->predecessor_offsets[removed + 1]; ++i) {
+			if (this->overlap_graph.present[this->nodes[this->predecessors[i]]]) {
+				stack.push_back(this->predecessors[i]);
+			}
+		}
+		while (!stack.empty()) {
+			const int32_t node = stack.back();
+			stack.pop_back();
+
+			this->lengths[node] -= delta;
+			this->candidates.emplace(this->score(node), -this->nodes[node]);
+
+			for (int32_t i = this->predecessor_offsets[node]; i < this->predecessor_offsets[node + 1]; ++i) {
+				if (this->overlap_graph.present[this->nodes[this->predecessors[i]]]) {
+					stack.push_back(this->predecessors[i]);
+				}
+			}
+		}
+	}
+}
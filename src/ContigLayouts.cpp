@@ -0,0 +1,58 @@
+#include "../include/ContigLayouts.hpp"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+size_t ContigLayouts::add(std::span<const Placement> layout, size_t length) {
+	this->placements.insert(this->placements.end(), layout.begin(), layout.end());
+	this->starts.push_back(this->placements.size());
+	this->lengths.push_back(length);
+	return this->lengths.size() - 1;
+}
+
+size_t ContigLayouts::size() const {
+	return this->lengths.size();
+}
+
+size_t ContigLayouts::length(size_t contig) const {
+	return this->lengths[contig];
+}
+
+std::span<const Placement> ContigLayouts::layout(size_t contig) const {
+	return std::span<const Placement>(this->placements.data() + this->starts[contig], this->starts[contig + 1] - this->starts[contig]);
+}
+
+void ContigLayouts::decode(const ReadStore& reads, size_t contig, std::string& out) const {
+	// Réserver la place du contig entier, puis décoder chaque séquence après son chevauchement
+	out.reserve(out.length() + this->lengths[contig]);
+	for (const Placement& placement : this->layout(contig)) {
+		reads.decode(placement.id, placement.overlap, out);
+	}
+}
+
+void ContigLayouts::retain(const std::vector<uint8_t>& keep) {
+	// Décaler les contigs gardés vers le début, sans allocation
+	size_t kept = 0;
+	uint64_t written = 0;
+	for (size_t contig = 0; contig < this->lengths.size(); ++contig) {
+		if (!keep[contig]) {
+			continue;
+		}
+		const uint64_t begin = this->starts[contig];
+		const uint64_t end = this->starts[contig + 1];
+		for (uint64_t i = begin; i < end; ++i) {
+			this->placements[written++] = this->placements[i];
+		}
+		this->lengths[kept] = this->lengths[contig];
+		this->starts[kept + 1] = written;
+		kept++;
+	}
+	this->placements.resize(written);
+	this->starts.resize(kept + 1);
+	this->lengths.resize(kept);
+}
+
+size_t ContigLayouts::memory() const {
+	return this->placements.capacity() * sizeof(Placement) + this->starts.capacity() * sizeof(uint64_t) + this->lengths.capacity() * sizeof(uint64_t);
+}
@@ -0,0 +1,365 @@
+#include "../include/DiskKmerCounter.hpp"
+#include "../include/PackedKmerSet.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+DiskKmerCounter::DiskKmerCounter(int k, uint64_t expected_kmers, size_t max_mem) : k(k), m(std::min(k, MINIMIZER_LENGTH)), max_mem(max_mem) {
+	if (max_mem < min_memory()) {
+		throw std::invalid_argument("Budget de mémoire trop petit : " + std::to_string(max_mem) + " octets (au moins " + std::to_string(min_memory()) + ")");
+	}
+
+	// Les blocs relus prennent au plus la moitié du budget (entre MIN_READ_SIZE et MAX_BUFFER_SIZE), la table d'une
+	// partition dispose du reste
+	this->read_size = std::clamp<size_t>(max_mem / (2 * BYTES_PER_READ_BYTE), MIN_READ_SIZE, MAX_BUFFER_SIZE);
+	this->table_mem = max_mem - this->read_size * BYTES_PER_READ_BYTE;
+
+	// Les tables vides d'une passe prennent au plus la moitié de ce reste, sans dépasser la taille initiale par défaut
+	this->initial_slots = MIN_TABLE_SLOTS;
+	while (2 * this->initial_slots <= PackedKmerSet::INITIAL_SLOTS && PackedKmerSet::table_memory(2 * this->initial_slots) <= this->table_mem / 2) {
+		this->initial_slots *= 2;
+	}
+
+	// Nouveau répertoire temporaire au nom imprévisible, créé par mkdtemp avec les seuls droits de l'utilisateur
+	std::string name = (std::filesystem::temp_directory_path() / "olp_asm_XXXXXX").string();
+	if (mkdtemp(name.data()) == nullptr) {
+		throw std::runtime_error("Erreur lors de la création du répertoire temporaire : " + name);
+	}
+	this->directory = name;
+
+	// Le destructeur n'étant pas appelé si le constructeur échoue, le répertoire est supprimé avant de lever l'erreur
+	auto fail = [&](const std::filesystem::path& file) {
+		this->files.clear();
+		this->n_file.close();
+		std::error_code error;
+		std::filesystem::remove_all(this->directory, error);
+		throw std::runtime_error("Erreur lors de l'ouverture du fichier : " + file.string());
+	};
+
+	// Ouvrir un fichier par partition, les tampons d'écriture des partitions et des k-mers contenant une base N
+	// se partageant le budget
+	const uint64_t partitions = std::min(this->passes(expected_kmers * BYTES_PER_KMER), MAX_PARTITIONS);
+	this->write_size = std::clamp<size_t>(max_mem / (partitions + 1), MIN_WRITE_SIZE, MAX_BUFFER_SIZE);
+	this->files.resize(partitions);
+	this->buffers.resize(partitions);
+	this->kmers.assign(partitions, 0);
+	for (size_t partition = 0; partition < partitions; ++partition) {
+		this->files[partition].open(this->path(partition), std::ios::binary | std::ios::trunc);
+		if (!this->files[partition].is_open()) {
+			fail(this->path(partition));
+		}
+		this->buffers[partition].reserve(this->write_size);
+	}
+	this->n_buffer.reserve(this->write_size);
+	this->n_file.open(this->n_path(), std::ios::binary | std::ios::trunc);
+	if (!this->n_file.is_open()) {
+		fail(this->n_path());
+	}
+}
+
+DiskKmerCounter::~DiskKmerCounter() {
+	this->files.clear();
+	this->n_file.close();
+	std::error_code error;
+	std::filesystem::remove_all(this->directory, error);
+}
+
+std::filesystem::path DiskKmerCounter::path(size_t partition) const {
+	return this->directory / ("partition_" + std::to_string(partition) + ".bin");
+}
+
+std::filesystem::path DiskKmerCounter::n_path() const {
+	return this->directory / "n_kmers.txt";
+}
+
+void DiskKmerCounter::check(const std::ios& stream, const std::string& action, const std::filesystem::path& file) {
+	if (stream.fail()) {
+		throw std::runtime_error("Erreur lors de " + action + " du fichier : " + file.string());
+	}
+}
+
+uint64_t DiskKmerCounter::passes(uint64_t bytes) const {
+	// Chaque passe commence par des tables vides, comptées dans le budget avant les k-mers
+	const uint64_t available = this->table_mem - PackedKmerSet::table_memory(this->initial_slots);
+	return std::max<uint64_t>((bytes + available - 1) / available, 1);
+}
+
+void DiskKmerCounter::write(size_t partition, std::string_view super_kmer) {
+	// Vider le tampon avant qu'il ne dépasse sa taille
+	std::vector<uint8_t>& buffer = this->buffers[partition];
+	if (buffer.size() + 1 + (super_kmer.length() + 3) / 4 > this->write_size) {
+		this->flush(partition);
+	}
+	buffer.push_back(super_kmer.length());
+	for (size_t i = 0; i < super_kmer.length(); i += 4) {
+		uint8_t packed = 0;
+		for (size_t j = i; j < std::min(i + 4, super_kmer.length()); ++j) {
+			packed |= ReadStore::encode(super_kmer[j]) << (2 * (j - i));
+		}
+		buffer.push_back(packed);
+	}
+	this->kmers[partition] += super_kmer.length() - this->k + 1;
+}
+
+void DiskKmerCounter::flush(size_t partition) {
+	std::vector<uint8_t>& buffer = this->buffers[partition];
+	this->files[partition].write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+	check(this->files[partition], "l'écriture", this->path(partition));
+	buffer.clear();
+}
+
+void DiskKmerCounter::flush_n() {
+	this->n_file.write(this->n_buffer.data(), this->n_buffer.size());
+	check(this->n_file, "l'écriture", this->n_path());
+	this->n_buffer.clear();
+}
+
+size_t DiskKmerCounter::add_kmers(std::string_view sequence) {
+	const size_t k = this->k;
+	const size_t m = this->m;
+	const uint64_t mask = (uint64_t(1) << (2 * m)) - 1;
+
+	// Empreinte du m-mer commençant à chaque position (tampon propre à chaque thread)
+	thread_local std::vector<uint64_t> hashes;
+	hashes.resize(sequence.length());
+
+	// Super-k-mer en cours : début, fin et position de son minimiseur
+	size_t start = 0;
+	size_t end = 0;
+	size_t minimizer = SIZE_MAX;
+	auto close = [&]() {
+		if (end > start) {
+			this->write(hashes[minimizer] % this->files.size(), sequence.substr(start, end - start));
+		}
+		start = end = 0;
+		minimizer = SIZE_MAX;
+	};
+
+	size_t cpt = 0;
+	uint64_t mmer = 0;
+	size_t valid = 0;
+	size_t last_n = SIZE_MAX;
+	size_t best = SIZE_MAX;
+	for (size_t i = 0; i < sequence.length(); ++i) {
+		const char base = sequence[i];
+		if (ReadStore::encode(base) == 0 && base != 'A' && base != 'a') {
+			// Une base N termine le super-k-mer en cours
+			close();
+			valid = 0;
+			last_n = i;
+			best = SIZE_MAX;
+		} else {
+			mmer = ((mmer << 2) | ReadStore::encode(base)) & mask;
+			valid++;
+			if (valid >= m) {
+				// Empreinte décalée du nombre d'or, pour ne pas favoriser les m-mers pauvres en C, G et T (AAA…A codé 0)
+				hashes[i + 1 - m] = splitmix64(mmer + 0x9E3779B97F4A7C15ULL);
+			}
+		}
+		if (i + 1 < k) {
+			continue;
+		}
+		cpt++;
+
+		// Les k-mers contenant une base N sont écrits en clair dans leur fichier, comptés à la fin
+		const size_t kmer_start = i + 1 - k;
+		if (last_n != SIZE_MAX && last_n >= kmer_start) {
+			if (this->n_buffer.size() + k > this->write_size) {
+				this->flush_n();
+			}
+			this->n_buffer.append(sequence.substr(kmer_start, k));
+			this->n_kmers++;
+			continue;
+		}
+
+		// Minimiseur du k-mer : le m-mer d'empreinte minimale le plus à gauche, qui ne dépend que du contenu du k-mer.
+		// Il n'est recherché dans tout le k-mer que lorsque le précédent en sort.
+		const size_t last = i + 1 - m;
+		if (best == SIZE_MAX || best < kmer_start) {
+			best = kmer_start;
+			for (size_t pos = kmer_start + 1; pos <= last; ++pos) {
+				if (hashes[pos] < hashes[best]) {
+					best = pos;
+				}
+			}
+		} else if (hashes[last] < hashes[best]) {
+			best = last;
+		}
+
+		// Prolonger le super-k-mer si le minimiseur est le même, sinon en commencer un autre
+		if (best == minimizer) {
+			end = i + 1;
+		} else {
+			close();
+			start = kmer_start;
+			end = i + 1;
+			minimizer = best;
+		}
+	}
+	close();
+
+	// Retourner le nombre de k-mers générés
+	return cpt;
+}
+
+std::vector<uint64_t> DiskKmerCounter::count(uint32_t min_count, bool bloom_filter, size_t max_count, ThreadPool& pool, ReadStore& reads) {
+	std::vector<uint64_t> histogram(max_count + 1, 0);
+	auto add_histogram = [&](const std::vector<uint64_t>& partial) {
+		for (size_t i = 0; i < histogram.size(); ++i) {
+			histogram[i] += partial[i];
+		}
+	};
+
+	// Terminer l'écriture des partitions
+	for (size_t partition = 0; partition < this->files.size(); ++partition) {
+		this->flush(partition);
+		this->files[partition].close();
+		check(this->files[partition], "la fermeture", this->path(partition));
+	}
+	this->flush_n();
+	this->n_file.close();
+	check(this->n_file, "la fermeture", this->n_path());
+
+	// Libérer les tampons d'écriture, le budget revenant aux blocs relus et aux tables
+	this->buffers = std::vector<std::vector<uint8_t>>();
+	this->n_buffer = std::string();
+
+	// Compter chaque partition à part : seuls sa table et un bloc de son fichier sont en mémoire
+	std::vector<uint8_t> data(this->read_size);
+	std::string text;
+	std::vector<size_t> starts;
+	std::vector<std::string_view> views;
+	uint64_t split_partitions = 0;
+	const bool filtered = bloom_filter && min_count >= 2;
+	for (size_t partition = 0; partition < this->files.size(); ++partition) {
+		// Une partition trop grande pour le budget est relue en plusieurs passes, une par tranche de ses k-mers
+		const uint64_t passes = this->passes(this->kmers[partition] * (BYTES_PER_KMER + (filtered ? BYTES_PER_FILTERED_KMER : 0)));
+		split_partitions += passes > 1;
+		for (uint64_t pass = 0; pass < passes; ++pass) {
+			PackedKmerSet kmer_set(this->k, this->initial_slots);
+			kmer_set.use_slice(pass, passes);
+			if (filtered) {
+				kmer_set.use_filter(this->kmers[partition] / passes);
+			}
+
+			// Relire le fichier par blocs, chaque bloc étant décodé et k-mérisé en parallèle ; un super-k-mer coupé
+			// par la fin d'un bloc est complété par le bloc suivant
+			std::ifstream file(this->path(partition), std::ios::binary);
+			check(file, "l'ouverture", this->path(partition));
+			size_t filled = 0;
+			while (true) {
+				file.read(reinterpret_cast<char*>(data.data()) + filled, data.size() - filled);
+				if (file.bad()) {
+					throw std::runtime_error("Erreur lors de la lecture du fichier : " + this->path(partition).string());
+				}
+				filled += file.gcount();
+				if (filled == 0) {
+					break;
+				}
+
+				text.clear();
+				starts.assign(1, 0);
+				size_t pos = 0;
+				while (pos < filled && pos + 1 + (data[pos] + 3) / 4 <= filled) {
+					const size_t length = data[pos++];
+					for (size_t i = 0; i < length; ++i) {
+						text.push_back("ACGT"[(data[pos + i / 4] >> (2 * (i % 4))) & 3]);
+					}
+					pos += (length + 3) / 4;
+					starts.push_back(text.size());
+				}
+
+				// Un super-k-mer incomplet à la fin du fichier
+				if (pos == 0) {
+					throw std::runtime_error("Erreur lors de la lecture du fichier : " + this->path(partition).string());
+				}
+				views.clear();
+				for (size_t i = 0; i + 1 < starts.size(); ++i) {
+					views.emplace_back(text.data() + starts[i], starts[i + 1] - starts[i]);
+				}
+				kmer_set.add_kmers(std::span<const std::string_view>(views), pool);
+
+				// Garder la fin du bloc, début du super-k-mer suivant
+				std::copy(data.begin() + pos, data.begin() + filled, data.begin());
+				filled -= pos;
+			}
+
+			// Garder les k-mers solides de la tranche, puis libérer sa table
+			add_histogram(kmer_set.histogram(max_count));
+			kmer_set.store(reads, min_count);
+		}
+		std::error_code error;
+		std::filesystem::remove(this->path(partition), error);
+
+		// Affichage de la progression
+		std::cout << "\rNombre de partitions comptées : [" << partition + 1 << "/" << this->files.size() << "]" << std::flush;
+	}
+	std::cout << std::endl;
+	if (split_partitions > 0) {
+		std::cout << "Nombre de partitions relues en plusieurs passes (budget de mémoire) : [" << split_partitions << "]" << std::endl;
+	}
+
+	// Les k-mers contenant une base N, relus depuis leur fichier
+	this->count_n_kmers(min_count, histogram, reads);
+
+	return histogram;
+}
+
+void DiskKmerCounter::count_n_kmers(uint32_t min_count, std::vector<uint64_t>& histogram, ReadStore& reads) {
+	const size_t k = this->k;
+	const size_t max_count = histogram.size() - 1;
+
+	// Chaque passe ne compte que les k-mers d'une tranche de leurs empreintes
+	const uint64_t passes = this->passes(this->n_kmers * (k + BYTES_PER_N_KMER));
+	std::string chunk(std::max<size_t>(this->read_size / k, 1) * k, '\0');
+	for (uint64_t pass = 0; pass < passes; ++pass) {
+		std::ifstream file(this->n_path(), std::ios::binary);
+		check(file, "l'ouverture", this->n_path());
+
+		KmerCounts counts;
+		while (file) {
+			file.read(chunk.data(), chunk.size());
+			if (file.bad()) {
+				throw std::runtime_error("Erreur lors de la lecture du fichier : " + this->n_path().string());
+			}
+			const size_t read = file.gcount();
+			for (size_t pos = 0; pos + k <= read; pos += k) {
+				std::string_view kmer(chunk.data() + pos, k);
+				if (KmerHash{}(kmer) % passes != pass) {
+					continue;
+				}
+				auto it = counts.find(kmer);
+				if (it == counts.end()) {
+					counts.emplace(kmer, 1);
+				} else {
+					it->second++;
+				}
+			}
+		}
+
+		for (const auto& [kmer, count] : counts) {
+			histogram[std::min<size_t>(count, max_count)]++;
+			if (count >= min_count) {
+				reads.add(kmer);
+			}
+		}
+	}
+}
+
+size_t DiskKmerCounter::min_memory() {
+	return MIN_READ_SIZE * BYTES_PER_READ_BYTE + 2 * PackedKmerSet::table_memory(MIN_TABLE_SLOTS);
+}
+
+size_t DiskKmerCounter::size() const {
+	return this->files.size();
+}
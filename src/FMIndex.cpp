@@ -0,0 +1,399 @@
+#include "../include/FMIndex.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Symboles du texte indexé : fin de texte, séparateur, puis les bases
+static const uint8_t END = 0;
+static const uint8_t SEPARATOR = 1;
+
+// Espacement des points de contrôle des occurrences dans la BWT
+static const uint64_t STEP = 64;
+
+// Symbole d'une base dans le texte indexé
+static uint8_t symbol_code(char base) {
+	return (base == 'N') ? 6 : ReadStore::encode(base) + 2;
+}
+
+/**
+ * @brief Trie les suffixes d'un texte par induction (SA-IS, Nong, Zhang et Chan 2009), en temps et en mémoire linéaires.
+ *
+ * Les suffixes LMS (S précédé d'un L) sont triés par induction, nommés, puis triés récursivement si des noms se répètent.
+ * Le tri de tous les suffixes est ensuite induit à partir de l'ordre des suffixes LMS. Le tableau des suffixes sert aussi
+ * de mémoire de travail : seuls les types des suffixes (un bit chacun) et les paniers des symboles sont alloués en plus.
+ *
+ * @param text Le texte, de symboles 0 à sigma - 1, le dernier symbole étant unique et le plus petit.
+ * @param sa Le tableau des suffixes à remplir, de taille n.
+ * @param n La longueur du texte.
+ * @param sigma Le nombre de symboles.
+**/
+template <typename Symbol, typename Index>
+static void sais(const Symbol* text, Index* sa, Index n, Index sigma) {
+	if (n == 1) {
+		sa[0] = 0;
+		return;
+	}
+
+	// Type de chaque suffixe : S s'il est plus petit que le suivant, L sinon
+	std::vector<bool> stype(n);
+	stype[n - 1] = true;
+	for (Index i = n - 2; i >= 0; --i) {
+		stype[i] = text[i] < text[i + 1] || (text[i] == text[i + 1] && stype[i + 1]);
+	}
+	auto is_lms = [&](Index i) { return i > 0 && stype[i] && !stype[i - 1]; };
+
+	// Début ou fin du panier de chaque symbole
+	std::vector<Index> buckets(sigma);
+	auto bucket_bounds = [&](bool ends) {
+		std::fill(buckets.begin(), buckets.end(), 0);
+		for (Index i = 0; i < n; ++i) {
+			buckets[text[i]]++;
+		}
+		Index sum = 0;
+		for (Index c = 0; c < sigma; ++c) {
+			sum += buckets[c];
+			buckets[c] = ends ? sum : sum - buckets[c];
+		}
+	};
+
+	// Induit l'ordre des suffixes L de gauche à droite, puis celui des suffixes S de droite à gauche
+	auto induce = [&]() {
+		bucket_bounds(false);
+		for (Index i = 0; i < n; ++i) {
+			if (sa[i] > 0 && !stype[sa[i] - 1]) {
+				sa[buckets[text[sa[i] - 1]]++] = sa[i] - 1;
+			}
+		}
+		bucket_bounds(true);
+		for (Index i = n - 1; i >= 0; --i) {
+			if (sa[i] > 0 && stype[sa[i] - 1]) {
+				sa[--buckets[text[sa[i] - 1]]] = sa[i] - 1;
+			}
+		}
+	};
+
+	// Trier les sous-chaînes LMS : les suffixes LMS en fin de panier, puis induction
+	bucket_bounds(true);
+	std::fill(sa, sa + n, -1);
+	for (Index i = 1; i < n; ++i) {
+		if (is_lms(i)) {
+			sa[--buckets[text[i]]] = i;
+		}
+	}
+	induce();
+
+	// Regrouper les suffixes LMS triés au début du tableau
+	Index n1 = 0;
+	for (Index i = 0; i < n; ++i) {
+		if (is_lms(sa[i])) {
+			sa[n1++] = sa[i];
+		}
+	}
+
+	// Nommer les sous-chaînes LMS, deux sous-chaînes identiques ayant le même nom. Deux positions LMS étant
+	// distantes d'au moins 2, le nom de la position pos est rangé en n1 + pos / 2
+	std::fill(sa + n1, sa + n, -1);
+	Index names = 0;
+	Index previous = -1;
+	for (Index i = 0; i < n1; ++i) {
+		const Index pos = sa[i];
+		bool different = false;
+		for (Index d = 0; d < n; ++d) {
+			if (previous == -1 || text[pos + d] != text[previous + d] || stype[pos + d] != stype[previous + d]) {
+				different = true;
+				break;
+			}
+			if (d > 0 && (is_lms(pos + d) || is_lms(previous + d))) {
+				break;
+			}
+		}
+		if (different) {
+			names++;
+			previous = pos;
+		}
+		sa[n1 + pos / 2] = names - 1;
+	}
+	for (Index i = n - 1, j = n - 1; i >= n1; --i) {
+		if (sa[i] >= 0) {
+			sa[j--] = sa[i];
+		}
+	}
+
+	// Trier les suffixes LMS : récursivement sur le texte réduit des noms si des noms se répètent
+	Index* sa1 = sa;
+	Index* reduced = sa + n - n1;
+	if (names < n1) {
+		sais<Index, Index>(reduced, sa1, n1, names);
+	} else {
+		for (Index i = 0; i < n1; ++i) {
+			sa1[reduced[i]] = i;
+		}
+	}
+
+	// Replacer les suffixes LMS triés en fin de panier, puis induire l'ordre de tous les suffixes
+	for (Index i = 1, j = 0; i < n; ++i) {
+		if (is_lms(i)) {
+			reduced[j++] = i;
+		}
+	}
+	for (Index i = 0; i < n1; ++i) {
+		sa1[i] = reduced[sa1[i]];
+	}
+	std::fill(sa + n1, sa + n, -1);
+	bucket_bounds(true);
+	for (Index i = n1 - 1; i >= 0; --i) {
+		const Index pos = sa[i];
+		sa[i] = -1;
+		sa[--buckets[text[pos]]] = pos;
+	}
+	induce();
+}
+
+/**
+ * @brief Calcule la BWT d'un texte et la position des séparateurs dans l'ordre de leurs lignes.
+ *
+ * Le tableau des suffixes, sur 32 bits par position si la longueur du texte le permet, n'existe que le temps du calcul.
+ *
+ * @param text Le texte, terminé par END et dont chaque séquence est précédée d'un SEPARATOR.
+ * @param sigma Le nombre de symboles.
+ * @param bwt La BWT à remplir.
+ * @param separator_positions La position dans le texte du séparateur de chaque ligne commençant par un séparateur, à remplir.
+**/
+template <typename Index>
+static void burrows_wheeler(const std::vector<uint8_t>& text, int sigma, std::vector<uint8_t>& bwt, std::vector<uint64_t>& separator_positions) {
+	const Index n = text.size();
+	std::vector<Index> sa(n);
+	sais<uint8_t, Index>(text.data(), sa.data(), n, sigma);
+
+	bwt.resize(n);
+	for (Index i = 0; i < n; ++i) {
+		bwt[i] = text[(sa[i] == 0) ? n - 1 : sa[i] - 1];
+	}
+
+	// Seul END précède les séparateurs dans l'ordre des symboles : leurs lignes suivent la première
+	separator_positions.clear();
+	for (Index row = 1; row < n && text[sa[row]] == SEPARATOR; ++row) {
+		separator_positions.push_back(sa[row]);
+	}
+}
+
+FMIndex::FMIndex(const ReadStore& reads, const std::vector<int32_t>& nodes) : reads(reads) {
+	// Construire le texte $s1$s2...$sn# et mémoriser la position de chaque séparateur
+	std::vector<uint8_t> text;
+	std::vector<uint64_t> separators;
+	for (int32_t id : nodes) {
+		separators.push_back(text.size());
+		text.push_back(SEPARATOR);
+		for (size_t pos = 0; pos < reads.length(id); ++pos) {
+			text.push_back(symbol_code(reads.base(id, pos)));
+		}
+	}
+	text.push_back(END);
+
+	// Nombre de symboles strictement inférieurs à chaque symbole
+	for (uint8_t symbol : text) {
+		this->counts[symbol + 1]++;
+	}
+	for (int c = 1; c <= SIGMA; ++c) {
+		this->counts[c] += this->counts[c - 1];
+	}
+
+	// Calculer la BWT par le tableau des suffixes, indexé sur 32 bits tant que le texte le permet, puis libérer le texte
+	std::vector<uint64_t> separator_positions;
+	if (text.size() <= static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+		burrows_wheeler<int32_t>(text, SIGMA, this->bwt, separator_positions);
+	} else {
+		burrows_wheeler<int64_t>(text, SIGMA, this->bwt, separator_positions);
+	}
+	text = std::vector<uint8_t>();
+	const uint64_t n = this->bwt.size();
+
+	// Points de contrôle des occurrences, tous les STEP symboles
+	this->occurrences.assign((n / STEP + 1) * SIGMA, 0);
+	std::array<uint64_t, SIGMA> running{};
+	for (uint64_t i = 0; i < n; ++i) {
+		if (i % STEP == 0) {
+			std::copy(running.begin(), running.end(), this->occurrences.begin() + (i / STEP) * SIGMA);
+		}
+		running[this->bwt[i]]++;
+	}
+	if (n % STEP == 0) {
+		std::copy(running.begin(), running.end(), this->occurrences.begin() + (n / STEP) * SIGMA);
+	}
+
+	// Les lignes commençant par un séparateur sont triées selon la séquence qui le suit
+	this->read_ranks.assign(reads.size(), -1);
+	for (size_t rank = 0; rank < separator_positions.size(); ++rank) {
+		const int32_t id = nodes[std::upper_bound(separators.begin(), separators.end(), separator_positions[rank]) - separators.begin() - 1];
+		this->separator_reads.push_back(id);
+		this->read_ranks[id] = rank;
+	}
+}
+
+uint64_t FMIndex::occ(uint8_t symbol, uint64_t pos) const {
+	// Partir du point de contrôle précédent et compter le reste
+	uint64_t result = this->occurrences[(pos / STEP) * SIGMA + symbol];
+	for (uint64_t i = pos - pos % STEP; i < pos; ++i) {
+		result += (this->bwt[i] == symbol);
+	}
+	return result;
+}
+
+Overlap FMIndex::best_overlap(size_t id, int min_overlap) const {
+	const size_t length = this->reads.length(id);
+	const int64_t own_rank = this->read_ranks[id];
+
+	// Intervalle courant, initialement toutes les lignes
+	uint64_t low = 0;
+	uint64_t high = this->bwt.size();
+
+	// Meilleur intervalle de séparateurs trouvé
+	size_t best_overlap = 0;
+	uint64_t best_low = 0;
+	uint64_t best_high = 0;
+
+	// Recherche arrière : le motif est le suffixe de la séquence, allongé d'une base à chaque étape
+	for (size_t overlap = 1; overlap <= length; ++overlap) {
+		const uint8_t symbol = symbol_code(this->reads.base(id, length - overlap));
+		low = this->counts[symbol] + this->occ(symbol, low);
+		high = this->counts[symbol] + this->occ(symbol, high);
+		if (low >= high) {
+			break;
+		}
+
+		// Les chevauchements trop courts ne sont pas retenus, inutile de compter leurs séparateurs
+		if (overlap < static_cast<size_t>(std::max(1, min_overlap))) {
+			continue;
+		}
+
+		// Séquences dont le préfixe est égal au suffixe courant, hormis la séquence elle-même
+		const uint64_t separator_low = this->occ(SEPARATOR, low);
+		const uint64_t separator_high = this->occ(SEPARATOR, high);
+		const bool contains_self = own_rank >= 0 && separator_low <= static_cast<uint64_t>(own_rank) && static_cast<uint64_t>(own_rank) < separator_high;
+		if (separator_high - separator_low > (contains_self ? 1u : 0u)) {
+			best_overlap = overlap;
+			best_low = separator_low;
+			best_high = separator_high;
+		}
+	}
+
+	// Aucun chevauchement trouvé
+	if (best_overlap == 0) {
+		return {-1, 0};
+	}
+
+	// Garder le premier successeur parmi ceux qui réalisent le plus long chevauchement
+	int32_t best_id = -1;
+	for (uint64_t rank = best_low; rank < best_high; ++rank) {
+		const int32_t candidate = this->separator_reads[rank];
+		if (candidate != static_cast<int32_t>(id) && (best_id == -1 || candidate < best_id)) {
+			best_id = candidate;
+		}
+	}
+	return {best_id, static_cast<int32_t>(best_overlap)};
+}
+
+bool FMIndex::search(size_t id, uint64_t& low, uint64_t& high) const {
+	// Recherche arrière de la séquence entière, à partir de toutes les lignes
+	low = 0;
+	high = this->bwt.size();
+	for (size_t pos = this->reads.length(id); pos > 0; --pos) {
+		const uint8_t symbol = symbol_code(this->reads.base(id, pos - 1));
+		low = this->counts[symbol] + this->occ(symbol, low);
+		high = this->counts[symbol] + this->occ(symbol, high);
+		if (low >= high) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FMIndex::is_contained(size_t id) const {
+	const size_t length = this->reads.length(id);
+
+	// Rangs des séparateurs des séquences commençant par la séquence cherchée
+	uint64_t prefix_low = 0;
+	uint64_t prefix_high = this->separator_reads.size();
+	if (length > 0) {
+		uint64_t low = 0;
+		uint64_t high = 0;
+		if (!this->search(id, low, high)) {
+			return false;
+		}
+
+		// Une occurrence qui ne suit pas un séparateur se trouve à l'intérieur d'une séquence plus longue
+		prefix_low = this->occ(SEPARATOR, low);
+		prefix_high = this->occ(SEPARATOR, high);
+		if (high - low > prefix_high - prefix_low) {
+			return true;
+		}
+	}
+	if (prefix_low == prefix_high) {
+		return false;
+	}
+
+	// Parmi les séquences qui commencent par elle, les copies identiques (suivies d'un séparateur) viennent en premier :
+	// la dernière est plus longue si l'une d'elles l'est
+	if (this->reads.length(this->separator_reads[prefix_high - 1]) > length) {
+		return true;
+	}
+
+	// Seule la copie de plus petit identifiant d'un groupe de séquences identiques est gardée
+	for (uint64_t rank = prefix_low; rank < prefix_high; ++rank) {
+		if (this->separator_reads[rank] < static_cast<int32_t>(id)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+int32_t FMIndex::container(size_t id) const {
+	const size_t length = this->reads.length(id);
+
+	// Rangs des séparateurs des séquences commençant par la séquence cherchée
+	uint64_t prefix_low = 0;
+	uint64_t prefix_high = this->separator_reads.size();
+	if (length > 0) {
+		uint64_t low = 0;
+		uint64_t high = 0;
+		if (!this->search(id, low, high)) {
+			return -1;
+		}
+
+		// Une occurrence qui ne suit pas un séparateur se trouve à l'intérieur d'une séquence plus longue :
+		// remonter le texte (LF) jusqu'au séparateur qui la précède, dont le rang donne la séquence
+		for (uint64_t row = low; row < high; ++row) {
+			if (this->bwt[row] == SEPARATOR) {
+				continue;
+			}
+			uint64_t current = row;
+			while (this->bwt[current] != SEPARATOR) {
+				const uint8_t symbol = this->bwt[current];
+				current = this->counts[symbol] + this->occ(symbol, current);
+			}
+			return this->separator_reads[this->occ(SEPARATOR, current)];
+		}
+		prefix_low = this->occ(SEPARATOR, low);
+		prefix_high = this->occ(SEPARATOR, high);
+	}
+	if (prefix_low == prefix_high) {
+		return -1;
+	}
+
+	// Parmi les séquences qui commencent par elle, les copies identiques viennent en premier : la dernière est la plus longue
+	const int32_t last = this->separator_reads[prefix_high - 1];
+	if (this->reads.length(last) > length) {
+		return last;
+	}
+
+	// Une copie identique d'identifiant plus petit, la plus petite
+	int32_t first = -1;
+	for (uint64_t rank = prefix_low; rank < prefix_high; ++rank) {
+		const int32_t copy = this->separator_reads[rank];
+		if (copy < static_cast<int32_t>(id) && (first == -1 || copy < first)) {
+			first = copy;
+		}
+	}
+	return first;
+}
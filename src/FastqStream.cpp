@@ -0,0 +1,76 @@
+#include "../include/FastqStream.hpp"
+#include <iostream>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+FastqStream::FastqStream(const std::string& filename, std::size_t buffer_size) : fastq(filename, std::ios::binary) {
+	// Vérifier si le fichier est ouvert avec succès
+	if (!this->fastq.is_open()) {
+		std::cerr << "Erreur d'ouverture du fichier FASTQ." << std::endl;
+		this->eof = true;
+		return;
+	}
+
+	// Allouer le tampon une seule fois, il ne grandit que pour une ligne plus longue que lui
+	this->buffer.resize(buffer_size > 0 ? buffer_size : 1);
+}
+
+bool FastqStream::is_open() const {
+	return this->fastq.is_open();
+}
+
+bool FastqStream::next_batch(std::vector<std::string_view>& batch) {
+	batch.clear();
+
+	// Ramener la ligne incomplète du bloc précédent au début du tampon
+	if (this->start > 0) {
+		std::memmove(this->buffer.data(), this->buffer.data() + this->start, this->filled - this->start);
+		this->filled -= this->start;
+		this->start = 0;
+	}
+
+	// Fin du fichier atteinte et tampon consommé
+	if (this->eof && this->filled == 0) {
+		return false;
+	}
+
+	// Compléter le tampon avec le bloc suivant du fichier
+	if (!this->eof) {
+		if (this->filled == this->buffer.size()) {
+			this->buffer.resize(2 * this->buffer.size());
+		}
+		this->fastq.read(this->buffer.data() + this->filled, this->buffer.size() - this->filled);
+		this->filled += this->fastq.gcount();
+		this->eof = this->fastq.eof() || this->fastq.gcount() == 0;
+	}
+
+	// Découper les lignes complètes, la dernière ligne du fichier peut ne pas finir par un saut de ligne
+	const char* data = this->buffer.data();
+	std::size_t pos = 0;
+	while (pos < this->filled) {
+		const char* end = static_cast<const char*>(std::memchr(data + pos, '\n', this->filled - pos));
+		if (end == nullptr && !this->eof) {
+			break;
+		}
+		std::size_t end_pos = (end == nullptr) ? this->filled : static_cast<std::size_t>(end - data);
+
+		if (this->line_idx % 4 == 1) {
+			// Ignorer le retour chariot des fichiers au format Windows
+			std::size_t length = end_pos - pos;
+			if (length > 0 && data[pos + length - 1] == '\r') {
+				length--;
+			}
+			batch.emplace_back(data + pos, length);
+		}
+
+		pos = end_pos + 1;
+		this->line_idx++;
+	}
+
+	// Mémoriser le début de la ligne incomplète
+	this->start = (pos < this->filled) ? pos : this->filled;
+
+	return true;
+}
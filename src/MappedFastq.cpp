@@ -0,0 +1,74 @@
+#include "../include/MappedFastq.hpp"
+#include <iostream>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+MappedFastq::MappedFastq(const std::string& filename) {
+	// Ouvrir le fichier FASTQ en mode lecture
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd == -1) {
+		std::cerr << "Erreur d'ouverture du fichier FASTQ." << std::endl;
+		return;
+	}
+
+	// Récupérer la taille du fichier, un fichier vide ne contient aucune séquence
+	struct stat infos;
+	if (fstat(fd, &infos) == -1 || infos.st_size == 0) {
+		close(fd);
+		return;
+	}
+
+	// Projeter le fichier en mémoire, le descripteur n'est plus nécessaire ensuite
+	void* mapping = mmap(nullptr, infos.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED) {
+		std::cerr << "Erreur de projection du fichier FASTQ." << std::endl;
+		return;
+	}
+
+	// Le fichier est parcouru une seule fois, du début à la fin
+	madvise(mapping, infos.st_size, MADV_SEQUENTIAL);
+	this->data = static_cast<const char*>(mapping);
+	this->size = infos.st_size;
+
+	// Repérer les lignes de séquence (deuxième ligne de chaque enregistrement) directement dans la projection
+	std::size_t pos = 0;
+	std::size_t idx = 0;
+	while (pos < this->size) {
+		const char* end = static_cast<const char*>(std::memchr(this->data + pos, '\n', this->size - pos));
+		std::size_t end_pos = (end == nullptr) ? this->size : static_cast<std::size_t>(end - this->data);
+
+		if (idx % 4 == 1) {
+			// Ignorer le retour chariot des fichiers au format Windows
+			std::size_t length = end_pos - pos;
+			if (length > 0 && this->data[pos + length - 1] == '\r') {
+				length--;
+			}
+			this->sequences.emplace_back(this->data + pos, length);
+		}
+
+		pos = end_pos + 1;
+		idx++;
+	}
+}
+
+MappedFastq::~MappedFastq() {
+	// Libérer la projection si elle existe
+	if (this->data != nullptr) {
+		munmap(const_cast<char*>(this->data), this->size);
+	}
+}
+
+bool MappedFastq::is_open() const {
+	return this->data != nullptr;
+}
+
+const std::vector<std::string_view>& MappedFastq::get_sequences() const {
+	return this->sequences;
+}
@@ -0,0 +1,178 @@
+#include "../include/MinimizerIndex.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+void MinimizerIndex::minimizers(size_t id, std::vector<std::pair<uint64_t, uint32_t>>& minimizers) const {
+	minimizers.clear();
+	const size_t length = this->reads.length(id);
+	if (length < static_cast<size_t>(this->k)) {
+		return;
+	}
+
+	// Une fenêtre compte w k-mers, ou tous les k-mers d'une séquence plus courte
+	const size_t kmers = length - this->k + 1;
+	const size_t window = std::min<size_t>(this->w, kmers);
+	const uint64_t mask = (uint64_t(1) << (2 * this->k)) - 1;
+
+	// File des k-mers candidats de la fenêtre courante, d'empreintes croissantes (le plus à gauche gagne les égalités)
+	thread_local std::deque<std::pair<uint64_t, uint32_t>> queue;
+	queue.clear();
+	uint64_t kmer = 0;
+	uint64_t bases = 0;
+	for (size_t pos = 0; pos < length; ++pos) {
+		// Lire les codes 32 par 32
+		if ((pos & 31) == 0) {
+			bases = this->reads.word(id, pos);
+		}
+		kmer = ((kmer << 2) | (bases & 3)) & mask;
+		bases >>= 2;
+		if (pos + 1 < static_cast<size_t>(this->k)) {
+			continue;
+		}
+
+		// Ajouter le k-mer commençant en start, puis retirer ceux sortis de la fenêtre
+		const uint32_t start = pos + 1 - this->k;
+		// Empreinte décalée du nombre d'or, pour ne pas favoriser les k-mers pauvres en C, G et T (AAA…A codé 0)
+		const uint64_t hash = splitmix64(kmer + 0x9E3779B97F4A7C15ULL);
+		while (!queue.empty() && queue.back().first > hash) {
+			queue.pop_back();
+		}
+		queue.emplace_back(hash, start);
+		while (queue.front().second + window <= start) {
+			queue.pop_front();
+		}
+
+		// Garder le minimiseur de chaque fenêtre complète, une seule fois
+		if (start + 1 >= window && (minimizers.empty() || minimizers.back().second != queue.front().second)) {
+			minimizers.push_back(queue.front());
+		}
+	}
+}
+
+MinimizerIndex::MinimizerIndex(const ReadStore& reads, const std::vector<int32_t>& nodes, int k, int w, int min_seeds) : reads(reads), k(k), w(w), min_seeds(min_seeds) {
+	// Calculer les minimiseurs de chaque séquence indexée
+	std::vector<std::tuple<uint64_t, int32_t, uint32_t>> entries;
+	std::vector<std::pair<uint64_t, uint32_t>> found;
+	for (int32_t id : nodes) {
+		this->minimizers(id, found);
+		for (const auto& [hash, pos] : found) {
+			entries.emplace_back(hash, id, pos);
+		}
+	}
+
+	// Trier les entrées par empreinte, puis par identifiant et position
+	std::sort(entries.begin(), entries.end());
+
+	// Répertoire des entrées selon les bits de poids fort de l'empreinte
+	int bits = 1;
+	while ((size_t(1) << bits) < entries.size() && bits < 32) {
+		bits++;
+	}
+	this->shift = 64 - bits;
+	this->directory.assign((size_t(1) << bits) + 1, 0);
+	for (const auto& entry : entries) {
+		this->directory[(std::get<0>(entry) >> this->shift) + 1]++;
+	}
+	for (size_t i = 1; i < this->directory.size(); ++i) {
+		this->directory[i] += this->directory[i - 1];
+	}
+
+	// Stocker les empreintes, les identifiants et les positions dans trois tableaux parallèles
+	this->keys.reserve(entries.size());
+	this->ids.reserve(entries.size());
+	this->positions.reserve(entries.size());
+	for (const auto& [hash, id, pos] : entries) {
+		this->keys.push_back(hash);
+		this->ids.push_back(id);
+		this->positions.push_back(pos);
+	}
+}
+
+Overlap MinimizerIndex::best_overlap(size_t id, int min_overlap) const {
+	const size_t length = this->reads.length(id);
+	const size_t minimum = std::max(1, min_overlap);
+
+	// Un chevauchement de la longueur minimale partage au moins une graine par fenêtre disjointe
+	const int32_t required = (this->min_seeds > 0) ? this->min_seeds : std::max(1, (static_cast<int>(minimum) - this->k + 1) / this->w);
+
+	// Minimiseurs de la séquence, diagonales trouvées (chevauchement négatif, candidat, nombre de graines)
+	// et dernière diagonale de chaque candidat (tampons propres à chaque thread)
+	thread_local std::vector<std::pair<uint64_t, uint32_t>> found;
+	thread_local std::vector<std::tuple<int64_t, int32_t, int32_t>> diagonals;
+	thread_local std::vector<int32_t> last_diagonal;
+	this->minimizers(id, found);
+	diagonals.clear();
+	if (last_diagonal.size() < this->reads.size()) {
+		last_diagonal.assign(this->reads.size(), -1);
+	}
+
+	// Chaque minimiseur partagé place le candidat sur une diagonale, qui fixe la longueur du chevauchement
+	for (const auto& [hash, pos] : found) {
+		const uint64_t bucket = hash >> this->shift;
+		uint64_t first = this->directory[bucket];
+		while (first < this->directory[bucket + 1] && this->keys[first] < hash) {
+			first++;
+		}
+		uint64_t last = first;
+		while (last < this->directory[bucket + 1] && this->keys[last] == hash) {
+			last++;
+		}
+		if (last - first > MAX_OCCURRENCES) {
+			continue;
+		}
+
+		for (uint64_t entry = first; entry < last; ++entry) {
+			// Le suffixe de la séquence commençant en length - overlap est le préfixe du candidat
+			const int32_t other = this->ids[entry];
+			const size_t overlap = length - pos + this->positions[entry];
+			if (overlap < minimum || overlap > std::min(length, this->reads.length(other))) {
+				continue;
+			}
+
+			// Les graines consécutives d'un candidat sur la même diagonale sont comptées ensemble
+			const int32_t previous = last_diagonal[other];
+			if (previous != -1 && std::get<0>(diagonals[previous]) == -static_cast<int64_t>(overlap)) {
+				std::get<2>(diagonals[previous])++;
+			} else {
+				last_diagonal[other] = diagonals.size();
+				diagonals.emplace_back(-static_cast<int64_t>(overlap), other, 1);
+			}
+		}
+	}
+	for (const auto& diagonal : diagonals) {
+		last_diagonal[std::get<1>(diagonal)] = -1;
+	}
+
+	// Vérifier les diagonales du plus long chevauchement au plus court, puis du plus petit identifiant au plus grand
+	std::sort(diagonals.begin(), diagonals.end());
+	for (size_t begin = 0, end = 0; begin < diagonals.size(); begin = end) {
+		int32_t seeds = 0;
+		while (end < diagonals.size() && std::get<0>(diagonals[end]) == std::get<0>(diagonals[begin]) && std::get<1>(diagonals[end]) == std::get<1>(diagonals[begin])) {
+			seeds += std::get<2>(diagonals[end]);
+			end++;
+		}
+		if (seeds < required) {
+			continue;
+		}
+
+		const size_t overlap = -std::get<0>(diagonals[begin]);
+		const int32_t other = std::get<1>(diagonals[begin]);
+
+		// Une séquence identique à la séquence de référence n'est pas un successeur
+		if (this->reads.length(other) == length && this->reads.equal(id, 0, other, 0, length)) {
+			continue;
+		}
+
+		// Vérifier le candidat base par base : le premier vérifié est le meilleur
+		if (this->reads.equal(id, length - overlap, other, 0, overlap)) {
+			return {other, static_cast<int32_t>(overlap)};
+		}
+	}
+
+	// Aucun chevauchement trouvé
+	return {-1, 0};
+}
@@ -1,21 +1,145 @@
 #include "../include/config.hpp"
 #include "../include/OverlapAssembler.hpp"
+#include "../include/MappedFastq.hpp"
+#include "../include/PrefixIndex.hpp"
+#include "../include/FMIndex.hpp"
+#include "../include/MinimizerIndex.hpp"
+#include "../include/OverlapKernel.hpp"
+#include "../include/ChainLengths.hpp"
+#include "../include/AhoCorasick.hpp"
+#include "../include/PackedKmerSet.hpp"
+#include "../include/DiskKmerCounter.hpp"
 #include <iostream>
 #include <vector>
-#include <unordered_map>
+#include <unordered_set>
+#include <string_view>
 #include <string>
 #include <fstream>
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <numeric>
+#include <memory>
+
+// Nombre de séquences d'un lot lu depuis un fichier projeté en mémoire
+static const size_t BATCH_SIZE = 1 << 16;
+
+// Nombre d'occurrences à partir duquel les k-mers sont regroupés dans le spectre affiché
+static const size_t SPECTRUM_MAX = 64;
+
+OverlapAssembler::OverlapAssembler(const std::string& filename, int k, std::size_t buffer_size, std::size_t threads, uint32_t min_kmer_count, std::size_t max_mem, bool bloom_filter) : pool(threads) {
+	// Avec un budget de mémoire, les k-mers sont répartis en super-k-mers dans des partitions sur le disque
+	const bool packed = k != -1 && k <= 32;
+	const bool on_disk = packed && max_mem > 0;
+	std::unique_ptr<DiskKmerCounter> disk_kmers;
+
+	// Ensemble des k-mers uniques : encodés sur 64 bits jusqu'à k = 32, sinon en chaînes interrogées avec des vues.
+	// Quand il ne sert pas (comptage sur le disque ou k > 32), il n'a qu'une case par partition, pour ne pas sortir du budget
+	PackedKmerSet packed_kmers(packed ? k : 1, (packed && !on_disk) ? PackedKmerSet::INITIAL_SLOTS : 1);
+	KmerCounts kmer_counts;
+
+	// Si demandé, les k-mers vus une seule fois ne pouvant être solides, ils ne sont notés que dans un filtre de Bloom
+	const bool filtered = packed && bloom_filter && min_kmer_count >= 2;
+
+	// Prépare la k-mérisation selon le nombre de k-mers attendu : partitions sur le disque ou filtres de Bloom
+	auto prepare = [&](uint64_t expected_kmers) {
+		if (on_disk) {
+			disk_kmers = std::make_unique<DiskKmerCounter>(k, expected_kmers, max_mem);
+			std::cout << "Nombre de partitions des " << k << "-mers sur le disque : [" << disk_kmers->size() << "]" << std::endl;
+		} else if (filtered) {
+			packed_kmers.use_filter(expected_kmers);
+		}
+	};
 
-OverlapAssembler::OverlapAssembler(const std::string& filename, int k) {
-	// Vérifie si la longueur des k-mers est spécifiée
-	if (k != -1) {
-		// k-mérise les séquences à partir du fichier FASTQ
-		sequences = kmerisation(read_fastq(filename), k);
+	// Transmet chaque lot de séquences à l'étape suivante : k-mérisation (en parallèle pour les k-mers encodés) ou compactage
+	auto consume = [&](std::span<const std::string_view> batch) {
+		if (on_disk) {
+			for (std::string_view sequence : batch) {
+				disk_kmers->add_kmers(sequence);
+			}
+			return;
+		}
+		if (packed) {
+			packed_kmers.add_kmers(batch, this->pool);
+			return;
+		}
+		for (std::string_view sequence : batch) {
+			if (k != -1) {
+				add_kmers(sequence, k, kmer_counts);
+			} else {
+				this->reads.add(sequence);
+			}
+		}
+	};
+
+	// Vérifie si la lecture en flux est demandée
+	if (buffer_size > 0) {
+		// Le nombre de reads n'est pas connu d'avance : il est estimé à partir du premier bloc du fichier
+		if (on_disk || filtered) {
+			prepare(estimate_kmers(filename, buffer_size, k));
+		}
+
+		// Chaque lot de séquences passe directement à l'étape suivante, sans garder le fichier en mémoire
+		stream_fastq(filename, buffer_size, [&](const std::vector<std::string_view>& batch) {
+			consume(batch);
+		});
 	} else {
-		// Utilise les séquences brutes du fichier FASTQ
-		sequences = read_fastq(filename);
+		// Projette le fichier FASTQ en mémoire, les séquences sont lues sans copie intermédiaire, par lots
+		// pour borner la taille des tampons de la k-mérisation
+		MappedFastq fastq(filename);
+		const std::vector<std::string_view>& sequences = fastq.get_sequences();
+
+		// Dimensionner les partitions ou les filtres de Bloom selon le nombre de k-mers des reads récupérés
+		if (on_disk || filtered) {
+			uint64_t expected_kmers = 0;
+			for (std::string_view sequence : sequences) {
+				expected_kmers += (sequence.length() >= static_cast<size_t>(k)) ? sequence.length() - k + 1 : 0;
+			}
+			prepare(expected_kmers);
+		}
+
+		for (size_t begin = 0; begin < sequences.size(); begin += BATCH_SIZE) {
+			consume(std::span<const std::string_view>(sequences).subspan(begin, std::min(BATCH_SIZE, sequences.size() - begin)));
+		}
+		std::cout << "Nombre de reads récupérés : [" << sequences.size() << "]" << std::endl;
+	}
+
+	// Compacte les k-mers solides (assez fréquents pour ne pas venir d'une erreur de séquençage),
+	// les k-mers encodés étant copiés sans décodage
+	if (on_disk) {
+		// Chaque partition est comptée à part, ses k-mers solides étant compactés au fur et à mesure
+		const std::vector<uint64_t> histogram = disk_kmers->count(min_kmer_count, filtered, SPECTRUM_MAX, this->pool, this->reads);
+		disk_kmers.reset();
+		std::cout << "Nombre de " << k << "-mers uniques : [" << std::accumulate(histogram.begin(), histogram.end(), uint64_t(0)) << "]" << std::endl;
+		print_kmer_spectrum(histogram, k, filtered);
+	} else if (packed) {
+		const std::vector<uint64_t> histogram = packed_kmers.histogram(SPECTRUM_MAX);
+		std::cout << "Nombre de " << k << "-mers uniques : [" << std::accumulate(histogram.begin(), histogram.end(), uint64_t(0)) << "]" << std::endl;
+		if (filtered) {
+			std::cout << "Mémoire des " << k << "-mers (filtre de Bloom compris) : [" << packed_kmers.memory() << " octets]" << std::endl;
+		}
+		print_kmer_spectrum(histogram, k, filtered);
+		packed_kmers.store(this->reads, min_kmer_count);
+	} else if (k != -1) {
+		std::vector<uint64_t> histogram(SPECTRUM_MAX + 1, 0);
+		for (const auto& [kmer, count] : kmer_counts) {
+			histogram[std::min<size_t>(count, SPECTRUM_MAX)]++;
+			if (count >= min_kmer_count) {
+				this->reads.add(kmer);
+			}
+		}
+		std::cout << "Nombre de " << k << "-mers uniques : [" << kmer_counts.size() << "]" << std::endl;
+		print_kmer_spectrum(histogram, k);
+	}
+	if (k != -1) {
+		std::cout << "Nombre de " << k << "-mers solides (⩾ " << min_kmer_count << " occurrences) : [" << this->reads.size() << "]" << std::endl;
 	}
 
+	// Affichage de la mémoire occupée par les séquences compactées
+	std::cout << "Mémoire des séquences (2 bits par base) : [" << this->reads.memory() << " octets]" << std::endl;
+
 	// Initialise les autres attributs de l'assembleur
 	this->k = k;
 	this->overlap_graph = {};
@@ -23,49 +147,204 @@ OverlapAssembler::OverlapAssembler(const std::string& filename, int k) {
 	this->trash = {};
 }
 
-void OverlapAssembler::MakeGraph() {
-	// Récupère les séquences à partir de l'assembleur
-	std::vector<std::string> sequences = this->sequences;
+std::vector<int32_t> OverlapAssembler::first_occurrences() const {
+	const size_t total = this->reads.size();
 
-	// Initialiser l'itérateur et le total de la barre de progression
-	int cpt = 1;
-	const int total = sequences.size();
+	// Les séquences identiques sont regroupées sur leur première occurrence
+	auto hash = [&](size_t id) { return this->reads.hash(id); };
+	auto equal = [&](size_t id1, size_t id2) { return this->reads.length(id1) == this->reads.length(id2) && this->reads.equal(id1, 0, id2, 0, this->reads.length(id1)); };
+	std::unordered_set<size_t, decltype(hash), decltype(equal)> unique_reads(total, hash, equal);
+
+	std::vector<int32_t> firsts(total);
+	for (size_t id = 0; id < total; ++id) {
+		firsts[id] = *unique_reads.insert(id).first;
+	}
+	return firsts;
+}
 
-	// Créer le graphe de chevauchement
-	for (const std::string& seq1 : sequences) {
-		this->overlap_graph[seq1] = calculate_overlap(seq1, sequences);
+void OverlapAssembler::RemoveContainedReads() {
+	const size_t total = this->reads.size();
 
-		// Affichage de la progression
-		std::cout << "\rNombre de nœuds crées : [" << cpt << "/" << total << "]" << std::flush;
-		cpt++;
+	// Les doublons sont regroupés sur leur première occurrence, seules les séquences distinctes sont cherchées
+	std::vector<int32_t> firsts = this->first_occurrences();
+	std::vector<int32_t> unique_reads;
+	for (size_t id = 0; id < total; ++id) {
+		if (firsts[id] == static_cast<int32_t>(id)) {
+			unique_reads.push_back(id);
+		}
 	}
+	firsts = std::vector<int32_t>();
+
+	// Index FM des séquences distinctes : chacune est cherchée en entier, en temps proportionnel à sa longueur.
+	// Une séquence distincte contenue dans une autre l'est dans une séquence plus longue
+	FMIndex index(this->reads, unique_reads);
+
+	// Chercher chaque séquence distincte, par blocs répartis entre les threads
+	std::vector<uint8_t> contained(unique_reads.size(), 0);
+	std::mutex progress_mutex;
+	size_t cpt = 0;
+	const size_t chunk = std::max<size_t>(64, unique_reads.size() / (16 * this->pool.size()) + 1);
+	this->pool.parallel_for(0, unique_reads.size(), chunk, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			contained[i] = index.is_contained(unique_reads[i]);
+		}
 
-	// Faire le saut de ligne
+		// Affichage de la progression
+		std::lock_guard<std::mutex> lock(progress_mutex);
+		cpt += end - begin;
+		std::cout << "\rNombre de reads vérifiés : [" << cpt << "/" << unique_reads.size() << "]" << std::flush;
+	});
 	std::cout << std::endl;
-}
 
-void OverlapAssembler::CleanGraph(int seuil) {
-	// Récupère le graphe de chevauchement à partir de l'assembleur
-	std::unordered_map<std::string, std::vector<std::string>> overlap_graph = this->overlap_graph;
+	// Garder les séquences maximales, qui seront les nœuds du graphe
+	this->nodes.clear();
+	for (size_t i = 0; i < unique_reads.size(); ++i) {
+		if (!contained[i]) {
+			this->nodes.push_back(unique_reads[i]);
+		}
+	}
+
+	// Affichage du nombre de reads retirés et restants
+	std::cout << "Nombre de reads retirés (doublons ou contenus) : [" << total - this->nodes.size() << "]" << std::endl;
+	std::cout << "Nombre de reads maximaux : [" << this->nodes.size() << "]" << std::endl;
+}
 
+int OverlapAssembler::adjust_seuil(int seuil) const {
 	// Vérifie si la longueur des k-mers est spécifiée et ajuste le seuil si nécessaire
 	if (this->k != -1 && this->k < seuil) {
 		seuil = this->k - static_cast<int>(0.2 * this->k);
 		std::cout << "\nLe seuil a été changé en " << seuil << ", car la valeur était supérieure à la taille des k-mers.\n" << std::endl;
 	}
+	return seuil;
+}
+
+void OverlapAssembler::MakeGraph(const std::string& engine, int seuil, int minimizer_k, int minimizer_w, int min_seeds) {
+	// Initialiser l'itérateur de la barre de progression
+	size_t cpt = 0;
+	const int total = this->reads.size();
+
+	// Les chevauchements plus courts que le seuil ne sont pas cherchés
+	seuil = this->adjust_seuil(seuil);
+	const int min_overlap = std::max(1, seuil);
+
+	// Initialise un nœud (absent) par séquence
+	this->overlap_graph.successors.assign(total, -1);
+	this->overlap_graph.scores.assign(total, 0);
+	this->overlap_graph.present.assign(total, 0);
+	this->overlap_graph.size = 0;
+
+	// Toutes les comparaisons de bases compactées passent par le noyau choisi pour le processeur
+	std::cout << "Noyau de comparaison : [" << overlap_kernel_name() << "]" << std::endl;
+
+	// Les séquences identiques partagent un seul nœud, celui de leur première occurrence : les séquences maximales gardées
+	// par RemoveContainedReads sont déjà regroupées, sinon seules les premières occurrences deviennent des nœuds
+	std::vector<int32_t> nodes = std::exchange(this->nodes, {});
+	if (nodes.empty()) {
+		const std::vector<int32_t> firsts = this->first_occurrences();
+		for (size_t id = 0; id < this->reads.size(); ++id) {
+			if (firsts[id] == static_cast<int32_t>(id)) {
+				nodes.push_back(id);
+			}
+		}
+	}
+
+	// Une séquence plus courte que le seuil ne peut ni atteindre le seuil ni servir de successeur à un nœud gardé : elle n'est pas indexée
+	std::vector<int32_t> indexed;
+	for (int32_t id : nodes) {
+		if (static_cast<int>(this->reads.length(id)) >= seuil) {
+			indexed.push_back(id);
+		}
+	}
+
+	// Calculer le meilleur successeur de chaque nœud, par blocs répartis entre les threads
+	std::vector<Overlap> results(nodes.size());
+	std::mutex progress_mutex;
+	auto fill_blocks = [&](size_t chunk, const std::function<void(size_t, size_t)>& fill_block) {
+		this->pool.parallel_for(0, nodes.size(), chunk, [&](size_t begin, size_t end) {
+			// Chaque bloc écrit uniquement dans ses propres cases de résultats
+			fill_block(begin, end);
+
+			// Affichage de la progression
+			std::lock_guard<std::mutex> lock(progress_mutex);
+			cpt += end - begin;
+			std::cout << "\rNombre de nœuds crées : [" << cpt << "/" << nodes.size() << "]" << std::flush;
+		});
+	};
+	auto fill_graph = [&](const std::function<Overlap(int32_t)>& best_overlap) {
+		fill_blocks(std::max<size_t>(64, nodes.size() / (16 * this->pool.size()) + 1), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				results[i] = (static_cast<int>(this->reads.length(nodes[i])) >= seuil) ? best_overlap(nodes[i]) : Overlap{-1, 0};
+			}
+		});
+	};
+
+	// Utiliser le moteur de chevauchement demandé
+	if (engine == "fm") {
+		// Index FM du texte formé de tous les nœuds indexés
+		FMIndex index(this->reads, indexed);
+		fill_graph([&](int32_t id) { return index.best_overlap(id, min_overlap); });
+	} else if (engine == "minimizer") {
+		// Index des minimiseurs des nœuds indexés, seuls les candidats partageant une diagonale sont vérifiés
+		MinimizerIndex index(this->reads, indexed, minimizer_k, minimizer_w, min_seeds);
+		fill_graph([&](int32_t id) { return index.best_overlap(id, min_overlap); });
+	} else if (engine == "brute") {
+		// Comparaison de chaque séquence avec toutes les autres, par blocs de séquences et tuiles de candidats
+		fill_blocks(64, [&](size_t begin, size_t end) {
+			calculate_overlaps(this->reads, std::span<const int32_t>(nodes).subspan(begin, end - begin), indexed, min_overlap, std::span<Overlap>(results).subspan(begin, end - begin));
+		});
+	} else {
+		// Index des empreintes des préfixes des nœuds indexés
+		PrefixIndex index(this->reads, indexed);
+		fill_graph([&](int32_t id) { return index.best_overlap(id, min_overlap); });
+	}
+
+	// Fusionner les résultats dans l'ordre des nœuds, le graphe ne dépend pas du nombre de threads
+	std::vector<int32_t> trash;
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		const int32_t id = nodes[i];
+		this->overlap_graph.successors[id] = results[i].id;
+		this->overlap_graph.scores[id] = results[i].score;
+
+		// Les nœuds sans chevauchement suffisant vont directement dans la corbeille
+		if (results[i].score < seuil) {
+			trash.push_back(id);
+		} else {
+			this->overlap_graph.present[id] = 1;
+			this->overlap_graph.size++;
+		}
+	}
+
+	// Faire le saut de ligne
+	std::cout << std::endl;
+
+	// Affichage du nombre de nœuds gardés et des nœuds rejetés
+	std::cout << "Nombre de nœuds restants : [" << this->overlap_graph.size << "]" << std::endl;
+	std::cout << "Nombre de nœuds rejetés : [" << trash.size() << "]" << std::endl;
+
+	// Stocke les séquences "inutiles" dans l'attribut trash de l'assembleur
+	this->trash = std::move(trash);
+}
+
+void OverlapAssembler::CleanGraph(int seuil) {
+	// Travaille directement sur le graphe de chevauchement de l'assembleur
+	OverlapGraph& overlap_graph = this->overlap_graph;
+
+	// Ajuste le seuil à la longueur des k-mers si nécessaire
+	seuil = this->adjust_seuil(seuil);
 
 	// Initialiser l'itérateur et le total de la barre de progression
 	int cpt = 1;
-	const int total = overlap_graph.size();
+	const int total = overlap_graph.size;
 
 	// Identifie les séquences à supprimer (celles avec un score inférieur au seuil)
-	std::vector<std::string> trash;
-	for (const auto& item : overlap_graph) {
-		const std::string& seq1 = item.first;
-		int score = std::stoi(item.second[1]);
+	std::vector<int32_t> trash;
+	for (size_t node = 0; node < overlap_graph.present.size(); ++node) {
+		if (!overlap_graph.present[node]) {
+			continue;
+		}
 
-		if (score < seuil) {
-			trash.push_back(seq1);
+		if (overlap_graph.scores[node] < seuil) {
+			trash.push_back(node);
 		}
 
 		// Affichage de la progression
@@ -77,183 +356,314 @@ void OverlapAssembler::CleanGraph(int seuil) {
 	std::cout << std::endl;
 
 	// Supprime les séquences "inutiles" du graphe de chevauchement
-	for (const auto& sequence : trash) {
-		overlap_graph.erase(sequence);
+	for (int32_t node : trash) {
+		overlap_graph.present[node] = 0;
 	}
+	overlap_graph.size -= trash.size();
 
 	// Affichage du nombre de nœuds restants et des nœuds rejetés
-	std::cout << "Nombre de nœuds restants : [" << overlap_graph.size() << "]" << std::endl;
+	std::cout << "Nombre de nœuds restants : [" << overlap_graph.size << "]" << std::endl;
 	std::cout << "Nombre de nœuds rejetés : [" << trash.size() << "]" << std::endl;
 
-	// Met à jour l'attribut overlap_graph de l'assembleur
-	this->overlap_graph = overlap_graph;
-
-	// Stocke les séquences "inutiles" dans l'attribut trash de l'assembleur
-	this->trash = trash;
+	// Ajoute les séquences "inutiles" à l'attribut trash de l'assembleur
+	this->trash.insert(this->trash.end(), trash.begin(), trash.end());
 }
 
-std::vector<std::string> OverlapAssembler::FindBestNode(const std::unordered_map<std::string, std::vector<std::string>>& overlap_graph) {
-	// Fonction locale pour calculer la longueur du chemin à partir d'un nœud
-	auto GetLengthPath = [&](const std::string& node) -> int {
-		std::vector<std::string> already_done;
-
-		// Vérifie si le nœud est présent dans le graphe et n'a pas de successeur
-		if (overlap_graph.find(node) == overlap_graph.end() || overlap_graph.at(node)[0] == "") {
-			return 0;
+int32_t OverlapAssembler::FindBestNode(const OverlapGraph& overlap_graph) {
+	// Calcule en une passe la longueur du chemin partant de chaque nœud présent et retourne le meilleur
+	std::vector<int32_t> nodes;
+	for (size_t node = 0; node < overlap_graph.present.size(); ++node) {
+		if (overlap_graph.present[node]) {
+			nodes.push_back(node);
 		}
+	}
+	ChainLengths chain_lengths(overlap_graph, nodes);
+	return chain_lengths.best_node();
+}
 
-		// Initialise la liste des nœuds déjà visités avec le nœud actuel
-		already_done.push_back(node);
-
-		// Initialise la longueur du chemin
-		int length = 1;
-		std::string next_node = overlap_graph.at(node)[0];
-
-		// Parcourt les nœuds suivants dans le chemin jusqu'à trouver un nœud sans successeur ou un nœud déjà visité
-		while (overlap_graph.find(next_node) != overlap_graph.end() && next_node != "" && std::find(already_done.begin(), already_done.end(), next_node) == already_done.end()) {
-			already_done.push_back(next_node);
-			length++;
-			next_node = overlap_graph.at(next_node)[0];
+void OverlapAssembler::AssembleContigs() {
+	// Consomme directement le graphe de chevauchement de l'assembleur
+	OverlapGraph& overlap_graph = this->overlap_graph;
+	const int32_t node_count = overlap_graph.present.size();
+
+	// Initialise l'itérateur et le total de la barre de progression
+	size_t cpt = 0;
+	const int total = overlap_graph.size;
+
+	// Composantes faiblement connexes des nœuds présents (union-find, la racine est le plus petit nœud)
+	std::vector<int32_t> parent(node_count);
+	for (int32_t node = 0; node < node_count; ++node) {
+		parent[node] = node;
+	}
+	auto find = [&](int32_t node) {
+		while (parent[node] != node) {
+			parent[node] = parent[parent[node]];
+			node = parent[node];
 		}
-
-		// Retourner la longueur du chemin
-		return length;
+		return node;
 	};
-
-	// Initialise les variables pour stocker le meilleur nœud
-	int best_length = 0;
-	std::vector<std::string> best_node{"", "", "0"};
-
-	// Parcourt tous les nœuds dans le graphe
-	for (const auto& item : overlap_graph) {
-		const std::string& seq1 = item.first;
-		const std::string& seq2 = item.second[0];
-
-		// Calcule la longueur du chemin pour le nœud actuel
-		int current_length = GetLengthPath(seq1);
-
-		// Met à jour le meilleur nœud si la longueur actuelle est supérieure
-		if (best_length < current_length) {
-			best_length = current_length;
-			best_node[0] = seq1;
-			best_node[1] = seq2;
-			best_node[2] = item.second[1];
+	for (int32_t node = 0; node < node_count; ++node) {
+		const int32_t next_node = overlap_graph.successors[node];
+		if (overlap_graph.present[node] && next_node != -1 && overlap_graph.present[next_node]) {
+			const int32_t root1 = find(node);
+			const int32_t root2 = find(next_node);
+			parent[std::max(root1, root2)] = std::min(root1, root2);
 		}
 	}
 
-	// Retourne le meilleur nœud trouvé
-	return best_node;
-};
+	// Regrouper les nœuds de chaque composante, triés, les composantes dans l'ordre de leur plus petit nœud
+	std::vector<int32_t> component_index(node_count, -1);
+	std::vector<int32_t> component_offsets(1, 0);
+	for (int32_t node = 0; node < node_count; ++node) {
+		if (overlap_graph.present[node] && find(node) == node) {
+			component_index[node] = component_offsets.size() - 1;
+			component_offsets.push_back(0);
+		}
+	}
+	for (int32_t node = 0; node < node_count; ++node) {
+		if (overlap_graph.present[node]) {
+			component_offsets[component_index[find(node)] + 1]++;
+		}
+	}
+	for (size_t i = 1; i < component_offsets.size(); ++i) {
+		component_offsets[i] += component_offsets[i - 1];
+	}
+	std::vector<int32_t> component_nodes(component_offsets.back());
+	std::vector<int32_t> filled(component_offsets.begin(), component_offsets.end() - 1);
+	for (int32_t node = 0; node < node_count; ++node) {
+		if (overlap_graph.present[node]) {
+			component_nodes[filled[component_index[find(node)]]++] = node;
+		}
+	}
+	const size_t component_count = component_offsets.size() - 1;
+
+	// Contig produit, avec la longueur du chemin et le nœud de départ au moment de son choix
+	struct Pick {
+		int32_t length;
+		int32_t node;
+		size_t component;
+		size_t index;
+	};
+	std::vector<std::vector<Pick>> picks(component_count);
+	std::vector<ContigLayouts> layouts(component_count);
+
+	// Assembler chaque composante indépendamment : une chaîne ne quitte jamais sa composante
+	std::mutex progress_mutex;
+	const size_t chunk = std::max<size_t>(1, component_count / (16 * this->pool.size()) + 1);
+	this->pool.parallel_for(0, component_count, chunk, [&](size_t begin, size_t end) {
+		std::vector<int32_t> chain;
+		std::vector<Placement> layout;
+		size_t consumed = 0;
+
+		for (size_t component = begin; component < end; ++component) {
+			// Longueurs des chemins de la composante, calculées une fois puis mises à jour à chaque chaîne retirée
+			const std::vector<int32_t> nodes(component_nodes.begin() + component_offsets[component], component_nodes.begin() + component_offsets[component + 1]);
+			ChainLengths chain_lengths(overlap_graph, nodes);
+
+			// Boucle jusqu'à ce que tous les nœuds de la composante soient utilisés
+			for (size_t remaining = nodes.size(); remaining > 0;) {
+				// Trouve le meilleur nœud de départ et le place en tête du contig
+				int32_t node = chain_lengths.best_node();
+				const int32_t length = chain_lengths.length(node);
+				chain.clear();
+				layout.clear();
+				layout.reserve(std::max(1, length) + 1);
+				layout.push_back({node, 0});
+				uint64_t contig_length = this->reads.length(node);
+
+				// Suit les successeurs tant qu'ils sont présents dans le graphe
+				while (true) {
+					// Place le nœud suivant à la suite du contig, après son chevauchement
+					int32_t next_node = overlap_graph.successors[node];
+					if (next_node != -1) {
+						const int32_t score = overlap_graph.scores[node];
+						layout.push_back({next_node, score});
+						contig_length += this->reads.length(next_node) - score;
+					}
+
+					// Supprime le nœud courant du graphe (seul ce thread modifie les nœuds de la composante)
+					overlap_graph.present[node] = 0;
+					remaining--;
+					chain.push_back(node);
+
+					// Vérifie si le nœud suivant est présent dans le graphe
+					if (next_node == -1 || !overlap_graph.present[next_node]) {
+						break;
+					}
+					node = next_node;
+				}
 
-void OverlapAssembler::AssembleContigs() {
-	// Récupère le graphe de chevauchement à partir de l'assembleur
-	std::unordered_map<std::string, std::vector<std::string>> overlap_graph = this->overlap_graph;
+				// Met à jour les longueurs des chemins qui rejoignaient la chaîne
+				chain_lengths.remove_chain(chain);
+				picks[component].push_back({length, layout[0].id, component, layouts[component].add(layout, contig_length)});
+			}
+			consumed += nodes.size();
+		}
 
-	// Initialise la liste des contigs
-	std::vector<std::string> contigs;
+		// Affichage de la progression
+		std::lock_guard<std::mutex> lock(progress_mutex);
+		cpt += consumed;
+		std::cout << "\rNombre de nœuds traités : [" << cpt << "/" << total << "]" << std::flush;
+	});
 
-	// Trouve le meilleur nœud de départ
-	std::vector<std::string> best_node = FindBestNode(overlap_graph);
+	// Faire le saut de ligne
+	std::cout << std::endl;
 
-	// Initialise le premier contig
-	std::string contig = concat_sequences(best_node[0], best_node[1], std::stoi(best_node[2]));
+	// Rassembler les contigs dans l'ordre d'un assemblage séquentiel : dans chaque composante, les choix se font
+	// par longueur de chemin décroissante puis par nœud croissant, il suffit donc de fusionner selon cet ordre
+	std::vector<Pick> order;
+	order.reserve(total);
+	for (const std::vector<Pick>& component_picks : picks) {
+		order.insert(order.end(), component_picks.begin(), component_picks.end());
+	}
+	picks = std::vector<std::vector<Pick>>();
+	std::sort(order.begin(), order.end(), [](const Pick& pick1, const Pick& pick2) {
+		return (pick1.length != pick2.length) ? pick1.length > pick2.length : pick1.node < pick2.node;
+	});
+	ContigLayouts contigs;
+	for (const Pick& pick : order) {
+		contigs.add(layouts[pick.component].layout(pick.index), layouts[pick.component].length(pick.index));
+	}
 
-	// Initialise le total de la barre de progression
-	const int total = overlap_graph.size();
+	// Affichage du nombre de reads obtenus et de la mémoire de leurs agencements
+	std::cout << "Nombre de contigs générés: [" << contigs.size() << "]" << std::endl;
+	std::cout << "Mémoire des contigs (agencements des séquences) : [" << contigs.memory() << " octets]" << std::endl;
 
-	// Boucle jusqu'à ce que tous les nœuds soient utilisés
-	while (!overlap_graph.empty()) {
-		// Vérifie si le nœud suivant est présent dans le graphe
-		if (overlap_graph.find(best_node[1]) != overlap_graph.end()) {
-			// Supprime le nœud courant du graphe
-			overlap_graph.erase(best_node[0]);
+	// Libère le graphe, entièrement consommé
+	overlap_graph = OverlapGraph();
 
-			// Met à jour les nœuds courant et suivant, ainsi que le score
-			best_node = {best_node[1], overlap_graph.at(best_node[1])[0], overlap_graph.at(best_node[1])[1]};
+	// Stocke les contigs résultants dans l'attribut contigs de l'assembleur
+	this->contigs = std::move(contigs);
+}
 
-			// Concatène la séquence du nœud suivant au contig actuel
-			contig = concat_sequences(contig, best_node[1], std::stoi(best_node[2]));
-		} 
-		else {
-			// Ajoute le contig actuel à la liste des contigs
-			contigs.push_back(contig);
+void OverlapAssembler::remove_contained_sequences(bool release_reads, const std::string& engine) {
+	// Ajouter directement les séquences de la corbeille aux contigs de l'assembleur, chacune formant un contig
+	ContigLayouts& contigs = this->contigs;
+	for (int32_t node : this->trash) {
+		const Placement placement{node, 0};
+		contigs.add(std::span<const Placement>(&placement, 1), this->reads.length(node));
+	}
+	this->trash = std::vector<int32_t>();
 
-			// Supprime le nœud courant du graphe
-			overlap_graph.erase(best_node[0]);
+	// Longueur des séquences courtes (moteur ac) : au plus deux fois la plus longue séquence d'entrée
+	size_t short_length = 0;
+	for (size_t id = 0; id < this->reads.size(); ++id) {
+		short_length = std::max(short_length, 2 * this->reads.length(id));
+	}
 
-			// Trouve le meilleur nœud de départ pour le prochain contig
-			best_node = FindBestNode(overlap_graph);
+	// Compacter les contigs sur 2 bits, en décodant un seul contig à la fois. Cette copie est nécessaire même sans libération
+	// des séquences d'entrée : les deux moteurs indexent des séquences entières d'un même stockage, alors qu'un contig de
+	// plusieurs reads n'existe que sous forme de placements, et l'identifiant d'une séquence y départage les copies identiques,
+	// qui doivent l'être dans l'ordre des contigs. Elle coûte 2 bits par base, moins que les index construits dessus
+	ReadStore packed;
+	std::string sequence;
+	for (size_t contig = 0; contig < contigs.size(); ++contig) {
+		sequence.clear();
+		contigs.decode(this->reads, contig, sequence);
+		packed.add(sequence);
+	}
 
-			// Initialise un nouveau contig avec le meilleur nœud trouvé
-			contig = concat_sequences(best_node[0], best_node[1], std::stoi(best_node[2]));
+	// Les contigs étant tous compactés, les séquences d'entrée ne servent plus si leur libération est demandée :
+	// chaque contig devient une seule séquence du stockage compacté
+	if (release_reads) {
+		ContigLayouts packed_contigs;
+		for (size_t contig = 0; contig < contigs.size(); ++contig) {
+			const Placement placement{static_cast<int32_t>(contig), 0};
+			packed_contigs.add(std::span<const Placement>(&placement, 1), packed.length(contig));
 		}
-
-		// Affichage de la progression
-		std::cout << "\rNombre de nœuds traités : [" << total - overlap_graph.size() << "/" << total << "]" << std::flush;
+		contigs = std::move(packed_contigs);
+		this->reads = ReadStore();
 	}
 
-	// Faire le saut de ligne
-	std::cout << std::endl;
-
-	// Affichage du nombre de reads obtenus
-	std::cout << "Nombre de contigs générés: [" << contigs.size() << "]" << std::endl;
-
-	// Stocke les contigs résultants dans l'attribut contigs de l'assembleur
-	this->contigs = contigs;
-}
+	// Initialiser l'itérateur et le total de la barre de progression
+	size_t cpt = 0;
+	const size_t total = contigs.size();
 
-void OverlapAssembler::remove_contained_sequences() {
-	// Récupérer les contigs
-	std::vector<std::string> contigs = this->contigs;
-	contigs.insert(contigs.end(), this->trash.begin(), this->trash.end());
+	// Tous les contigs sont à la fois cherchés et parcourus
+	std::vector<int32_t> ids(total);
+	for (size_t contig = 0; contig < total; ++contig) {
+		ids[contig] = contig;
+	}
+	std::vector<uint8_t> keep(total, 1);
+
+	// Utiliser le moteur de recherche demandé
+	if (engine == "ac") {
+		// Séquences courtes : les reads de la corbeille et les contigs pas plus longs que deux reads.
+		// Seules elles sont cherchées, dans un automate construit sur elles seules
+		std::vector<int32_t> patterns;
+		std::vector<int32_t> texts;
+		for (int32_t contig : ids) {
+			(contigs.length(contig) <= short_length ? patterns : texts).push_back(contig);
+		}
+		AhoCorasick automaton(packed, patterns);
 
-	// Initialiser la liste des index à retirer
-	std::vector<int> contained_sequences_index;
+		// Chaque contig long traverse l'automate une fois, puis chaque séquence courte (qui peut être contenue dans une autre
+		// séquence courte ou en être une copie identique) : une seule passe sur les bases des contigs
+		texts.insert(texts.end(), patterns.begin(), patterns.end());
+		for (int32_t contig : texts) {
+			automaton.scan(contig);
 
-	// Initialiser l'itérateur et le total de la barre de progression
-	int cpt = 1;
-	const int total = contigs.size();
+			// Affichage de la progression
+			cpt++;
+			std::cout << "\rNombre de contigs parcourus : [" << cpt << "/" << total << "]" << std::flush;
+		}
 
-	// Faire les comparaisons
-	for (size_t i = 0; i < contigs.size(); ++i) {
-		for (size_t j = 0; j < contigs.size(); ++j) {
-			// Si le contig1 est plus grand que le contig2, passer à l'itération suivante
-			if (contigs[i].length() > contigs[j].length()) {
-				continue;
-			}
-			// Si le contig1 est plus petit ou égal au contig2
-			else if (contigs[i].length() <= contigs[j].length()) {
-				// Vérifier si le contig1 est contenu dans le contig2
-				if (i != j && contigs[j].find(contigs[i]) != std::string::npos) {
-					contained_sequences_index.push_back(i);
-					break;
-				}
-			}
+		// Une séquence courte est retirée si elle est apparue dans une séquence plus longue ou dans une copie qui la précède,
+		// les contigs longs sont tous gardés
+		for (int32_t contig : patterns) {
+			keep[contig] = automaton.container(contig) == -1;
 		}
+	} else {
+		// Index FM de tous les contigs : chaque contig est cherché en entier, en temps proportionnel à sa longueur
+		FMIndex index(packed, ids);
+
+		// Vérifier chaque contig, par blocs répartis entre les threads
+		std::mutex progress_mutex;
+		const size_t chunk = std::max<size_t>(64, total / (16 * this->pool.size()) + 1);
+		this->pool.parallel_for(0, total, chunk, [&](size_t begin, size_t end) {
+			// Un contig est retiré s'il apparaît dans un autre contig
+			for (size_t contig = begin; contig < end; ++contig) {
+				keep[contig] = !index.is_contained(contig);
+			}
 
-		// Affichage de la progression
-		std::cout << "\rNombre de contigs vérifiés : [" << cpt << "/" << total << "]" << std::flush;
-		cpt++;
+			// Affichage de la progression
+			std::lock_guard<std::mutex> lock(progress_mutex);
+			cpt += end - begin;
+			std::cout << "\rNombre de contigs vérifiés : [" << cpt << "/" << total << "]" << std::flush;
+		});
 	}
 
 	// Faire le saut de ligne
 	std::cout << std::endl;
 
-	// Retirer les contigs contenus dans d'autres
-	for (auto it = contained_sequences_index.rbegin(); it != contained_sequences_index.rend(); ++it) {
-		contigs.erase(contigs.begin() + *it);
+	// Retirer les contigs contenus dans d'autres, en une passe
+	contigs.retain(keep);
+
+	// Ne garder dans le stockage compacté que les contigs restants, si les séquences d'entrée ont été libérées
+	if (release_reads) {
+		ReadStore kept_reads;
+		ContigLayouts kept_contigs;
+		for (size_t contig = 0; contig < contigs.size(); ++contig) {
+			sequence.clear();
+			packed.decode(contigs.layout(contig)[0].id, 0, sequence);
+			const Placement placement{static_cast<int32_t>(kept_reads.add(sequence)), 0};
+			kept_contigs.add(std::span<const Placement>(&placement, 1), contigs.length(contig));
+		}
+		contigs = std::move(kept_contigs);
+		this->reads = std::move(kept_reads);
+	} else {
+		// Les contigs restants se décodent toujours depuis les séquences d'entrée : la copie compactée ne sert plus
+		packed = ReadStore();
 	}
+	sequence = std::string();
 
 	// Affichage du nombre de contigs restants
 	std::cout << "Nombre de contigs restant : [" << contigs.size() << "]" << std::endl;
-
-	// Mettre à jour la liste des contigs
-	this->contigs = contigs;
 }
 
 void OverlapAssembler::SaveContigs(const std::string& filename, int min_length) {
-	// Combine les contigs et la corbeille
-	std::vector<std::string> contigs = this->contigs;
+	// Parcourt directement les contigs de l'assembleur
+	const ContigLayouts& contigs = this->contigs;
 
 	// Ouvre le fichier FASTA en mode écriture
 	std::ofstream fasta(filename);
@@ -267,12 +677,17 @@ void OverlapAssembler::SaveContigs(const std::string& filename, int min_length)
 	int cpt = 1;
 	const int total = contigs.size();
 
+	// Tampon de décodage, réutilisé d'un contig à l'autre
+	std::string contig;
+
 	// Parcourt tous les contigs
-	for (const std::string& contig : contigs) {
+	for (size_t i = 0; i < contigs.size(); ++i) {
 		// Vérifie si la longueur du contig est supérieure à la longueur minimale
-		int contig_length = contig.length();
+		int contig_length = contigs.length(i);
 		if (min_length <= contig_length) {
-			// Génère une ligne au format FASTA pour le contig et l'écrit dans le fichier
+			// Décode le contig, puis génère une ligne au format FASTA et l'écrit dans le fichier
+			contig.clear();
+			contigs.decode(this->reads, i, contig);
 			fasta << ">contig" << cpt << '\n' << contig << '\n' << '\n';
 
 			// Affichage de la progression
@@ -0,0 +1,108 @@
+#include "../include/OverlapKernel.hpp"
+#include <algorithm>
+#include <cstdint>
+#if defined(__x86_64__)
+	#include <immintrin.h>
+#endif
+
+// Noyau de comparaison : indique si deux fragments compactés de même longueur sont identiques
+typedef bool (*EqualKernel)(const uint64_t*, uint64_t, uint64_t, size_t);
+
+// Extrait 32 bases consécutives, à cheval sur deux mots si besoin
+static inline uint64_t extract(const uint64_t* words, uint64_t global) {
+	const uint64_t shift = (global & 31) * 2;
+	uint64_t result = words[global >> 5] >> shift;
+	if (shift != 0) {
+		result |= words[(global >> 5) + 1] << (64 - shift);
+	}
+	return result;
+}
+
+// Version scalaire : 32 bases par comparaison de mots
+static bool equal_scalar(const uint64_t* words, uint64_t start1, uint64_t start2, size_t length) {
+	for (size_t done = 0; done < length; done += 32) {
+		const size_t count = std::min<size_t>(32, length - done);
+		const uint64_t mask = (count == 32) ? ~uint64_t(0) : ((uint64_t(1) << (2 * count)) - 1);
+		if ((extract(words, start1 + done) ^ extract(words, start2 + done)) & mask) {
+			return false;
+		}
+	}
+	return true;
+}
+
+#if defined(__x86_64__)
+// Extrait 64 bases consécutives : deux mots décalés, complétés par les bits des mots suivants
+// (un décalage de 64 bits donne 0, le cas d'un fragment aligné n'est donc pas distingué)
+__attribute__((target("sse4.2")))
+static inline __m128i extract_sse42(const uint64_t* words, uint64_t global) {
+	const uint64_t* first = words + (global >> 5);
+	const int64_t shift = (global & 31) * 2;
+	const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+	const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + 1));
+	return _mm_or_si128(_mm_srl_epi64(low, _mm_cvtsi64_si128(shift)), _mm_sll_epi64(high, _mm_cvtsi64_si128(64 - shift)));
+}
+
+// Version SSE4.2 : 64 bases (16 octets) par comparaison
+__attribute__((target("sse4.2")))
+static bool equal_sse42(const uint64_t* words, uint64_t start1, uint64_t start2, size_t length) {
+	size_t done = 0;
+	for (; done + 64 <= length; done += 64) {
+		const __m128i difference = _mm_xor_si128(extract_sse42(words, start1 + done), extract_sse42(words, start2 + done));
+		if (!_mm_testz_si128(difference, difference)) {
+			return false;
+		}
+	}
+	return equal_scalar(words, start1 + done, start2 + done, length - done);
+}
+
+// Extrait 128 bases consécutives : quatre mots décalés, complétés par les bits des mots suivants
+__attribute__((target("avx2")))
+static inline __m256i extract_avx2(const uint64_t* words, uint64_t global) {
+	const uint64_t* first = words + (global >> 5);
+	const int64_t shift = (global & 31) * 2;
+	const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+	const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + 1));
+	return _mm256_or_si256(_mm256_srl_epi64(low, _mm_cvtsi64_si128(shift)), _mm256_sll_epi64(high, _mm_cvtsi64_si128(64 - shift)));
+}
+
+// Version AVX2 : 128 bases (32 octets) par comparaison
+__attribute__((target("avx2")))
+static bool equal_avx2(const uint64_t* words, uint64_t start1, uint64_t start2, size_t length) {
+	size_t done = 0;
+	for (; done + 128 <= length; done += 128) {
+		const __m256i difference = _mm256_xor_si256(extract_avx2(words, start1 + done), extract_avx2(words, start2 + done));
+		if (!_mm256_testz_si256(difference, difference)) {
+			return false;
+		}
+	}
+	return equal_scalar(words, start1 + done, start2 + done, length - done);
+}
+#endif
+
+// Choix du noyau selon le processeur, une seule fois au démarrage
+static EqualKernel select_kernel(const char** name) {
+#if defined(__x86_64__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		*name = "avx2";
+		return equal_avx2;
+	}
+	if (__builtin_cpu_supports("sse4.2")) {
+		*name = "sse4.2";
+		return equal_sse42;
+	}
+#endif
+	*name = "scalaire";
+	return equal_scalar;
+}
+
+static const char* kernel_name = nullptr;
+static const EqualKernel equal_kernel = select_kernel(&kernel_name);
+
+bool packed_equal(const uint64_t* words, uint64_t start1, uint64_t start2, size_t length) {
+	return equal_kernel(words, start1, start2, length);
+}
+
+const char* overlap_kernel_name() {
+	return kernel_name;
+}
@@ -0,0 +1,309 @@
+#include "../include/PackedKmerSet.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Code sur 2 bits d'une base, -1 pour une base N
+static int base_code(char base) {
+	switch (base) {
+		case 'A': case 'a': return 0;
+		case 'C': case 'c': return 1;
+		case 'G': case 'g': return 2;
+		case 'T': case 't': return 3;
+		default: return -1;
+	}
+}
+
+/**
+ * @brief Parcourt les k-mers d'une séquence : chaque k-mer encodé est déduit du précédent, la première base dans les bits de poids faible.
+ *
+ * @param sequence La séquence à k-mériser.
+ * @param k La longueur des k-mers.
+ * @param on_code La fonction appelée sur chaque k-mer encodé.
+ * @param on_other La fonction appelée sur chaque k-mer contenant une base N.
+ *
+ * @return Le nombre de k-mers de la séquence.
+**/
+template <typename OnCode, typename OnOther>
+static size_t for_each_kmer(std::string_view sequence, int k, OnCode&& on_code, OnOther&& on_other) {
+	size_t cpt = 0;
+	uint64_t code = 0;
+	size_t valid = 0;
+	for (size_t i = 0; i < sequence.length(); ++i) {
+		// La base la plus ancienne sort par le décalage, la nouvelle entre dans les bits de poids fort du k-mer,
+		// une base N interrompant les k-mers encodés
+		const int base = base_code(sequence[i]);
+		if (base < 0) {
+			valid = 0;
+		} else {
+			code = (code >> 2) | (static_cast<uint64_t>(base) << (2 * (k - 1)));
+			valid++;
+		}
+		if (i + 1 < static_cast<size_t>(k)) {
+			continue;
+		}
+
+		if (valid >= static_cast<size_t>(k)) {
+			on_code(code);
+		} else {
+			on_other(sequence.substr(i + 1 - k, k));
+		}
+		cpt++;
+	}
+	return cpt;
+}
+
+PackedKmerSet::PackedKmerSet(int k, size_t initial_slots) : k(k) {
+	this->partitions.resize(size_t(1) << PARTITION_BITS);
+	for (Partition& partition : this->partitions) {
+		partition.slots.assign(initial_slots, EMPTY);
+		partition.counts.assign(initial_slots, 0);
+	}
+}
+
+size_t PackedKmerSet::table_memory(size_t slots) {
+	return (size_t(1) << PARTITION_BITS) * slots * (sizeof(uint64_t) + sizeof(uint32_t));
+}
+
+void PackedKmerSet::use_filter(uint64_t expected_kmers) {
+	// Nombre de blocs de 512 bits de chaque partition, arrondi au bloc supérieur : le bloc d'un k-mer est choisi
+	// par multiplication, sans masque, pour ne pas arrondir la taille à une puissance de 2
+	const uint64_t bits = expected_kmers * FILTER_BITS_PER_KMER / this->partitions.size();
+	const uint64_t blocks = std::max<uint64_t>(1, (bits + 511) / 512);
+	for (Partition& partition : this->partitions) {
+		partition.filter.assign(blocks * 8, 0);
+	}
+}
+
+void PackedKmerSet::use_slice(size_t slice, size_t slices) {
+	this->slice = slice;
+	this->slices = slices;
+}
+
+bool PackedKmerSet::in_slice(uint64_t code) const {
+	// Une empreinte décorrélée de celles de la partition, de la case et du filtre de Bloom
+	return this->slices == 1 || splitmix64(code ^ 0x5851F42D4C957F2DULL) % this->slices == this->slice;
+}
+
+size_t PackedKmerSet::partition_of(uint64_t code) {
+	return splitmix64(code) >> (64 - PARTITION_BITS);
+}
+
+bool PackedKmerSet::test_and_set(Partition& partition, uint64_t code) {
+	// Une seconde empreinte choisit le bloc (ses 32 bits de poids fort ramenés au nombre de blocs), une troisième les bits
+	// marqués dans le bloc, 9 bits chacun
+	const uint64_t hash = splitmix64(code + 0x9E3779B97F4A7C15ULL);
+	const uint64_t bits = splitmix64(hash ^ 0xD6E8FEB86659FD93ULL);
+	uint64_t* block = partition.filter.data() + (((hash >> 32) * (partition.filter.size() / 8)) >> 32) * 8;
+	bool present = true;
+	for (int i = 0; i < FILTER_HASHES; ++i) {
+		const uint64_t bit = (bits >> (9 * i)) & 511;
+		const uint64_t mask = uint64_t(1) << (bit & 63);
+		present = present && (block[bit >> 6] & mask);
+		block[bit >> 6] |= mask;
+	}
+	return present;
+}
+
+void PackedKmerSet::insert(Partition& partition, uint64_t code) {
+	// Une première occurrence n'est notée que dans le filtre, une deuxième compte aussi la première
+	uint32_t occurrences = 1;
+	if (!partition.filter.empty()) {
+		if (!test_and_set(partition, code)) {
+			partition.first_sightings++;
+			return;
+		}
+		occurrences = 2;
+	}
+
+	if (code == EMPTY) {
+		partition.size += (partition.empty_count == 0);
+		partition.empty_count += (partition.empty_count == 0) ? occurrences : 1;
+		return;
+	}
+
+	// Garder la table remplie au plus aux trois quarts
+	if (4 * (partition.size + 1) > 3 * partition.slots.size()) {
+		grow(partition);
+	}
+
+	// Sondage linéaire à partir de la case donnée par l'empreinte
+	const size_t slot_mask = partition.slots.size() - 1;
+	for (size_t slot = splitmix64(code) & slot_mask;; slot = (slot + 1) & slot_mask) {
+		if (partition.slots[slot] == code) {
+			partition.counts[slot]++;
+			return;
+		}
+		if (partition.slots[slot] == EMPTY) {
+			partition.slots[slot] = code;
+			partition.counts[slot] = occurrences;
+			partition.size++;
+			return;
+		}
+	}
+}
+
+void PackedKmerSet::grow(Partition& partition) {
+	std::vector<uint64_t> slots(partition.slots.size() * 2, EMPTY);
+	std::vector<uint32_t> counts(partition.counts.size() * 2, 0);
+	const size_t slot_mask = slots.size() - 1;
+	for (size_t i = 0; i < partition.slots.size(); ++i) {
+		if (partition.slots[i] == EMPTY) {
+			continue;
+		}
+		size_t slot = splitmix64(partition.slots[i]) & slot_mask;
+		while (slots[slot] != EMPTY) {
+			slot = (slot + 1) & slot_mask;
+		}
+		slots[slot] = partition.slots[i];
+		counts[slot] = partition.counts[i];
+	}
+	partition.slots.swap(slots);
+	partition.counts.swap(counts);
+}
+
+void PackedKmerSet::insert_other(std::string_view kmer) {
+	auto it = this->others.find(kmer);
+	if (it == this->others.end()) {
+		this->others.emplace(kmer, 1);
+	} else {
+		it->second++;
+	}
+}
+
+size_t PackedKmerSet::add_kmers(std::string_view sequence) {
+	return for_each_kmer(sequence, this->k,
+		[&](uint64_t code) {
+			if (this->in_slice(code)) {
+				insert(this->partitions[partition_of(code)], code);
+			}
+		},
+		[&](std::string_view kmer) { this->insert_other(kmer); });
+}
+
+size_t PackedKmerSet::add_kmers(std::span<const std::string_view> sequences, ThreadPool& pool) {
+	const size_t total = this->partitions.size();
+	const size_t chunks = (sequences.size() + CHUNK - 1) / CHUNK;
+
+	// Tampons de chaque bloc : k-mers encodés rangés par partition (CSR) et k-mers contenant une base N
+	std::vector<std::vector<uint64_t>> codes(chunks);
+	std::vector<std::vector<uint64_t>> offsets(chunks);
+	std::vector<std::vector<std::string_view>> others(chunks);
+	std::vector<size_t> generated(chunks, 0);
+
+	// Répartition : chaque bloc de séquences est k-mérisé indépendamment
+	pool.parallel_for(0, sequences.size(), CHUNK, [&](size_t begin, size_t end) {
+		const size_t chunk = begin / CHUNK;
+		thread_local std::vector<uint64_t> found;
+		found.clear();
+		for (size_t i = begin; i < end; ++i) {
+			generated[chunk] += for_each_kmer(sequences[i], this->k,
+				[&](uint64_t code) {
+					if (this->in_slice(code)) {
+						found.push_back(code);
+					}
+				},
+				[&](std::string_view kmer) { others[chunk].push_back(kmer); });
+		}
+
+		// Ranger les k-mers par partition, en gardant leur ordre d'apparition
+		std::vector<uint64_t>& starts = offsets[chunk];
+		starts.assign(total + 1, 0);
+		for (uint64_t code : found) {
+			starts[partition_of(code) + 1]++;
+		}
+		for (size_t p = 0; p < total; ++p) {
+			starts[p + 1] += starts[p];
+		}
+		std::vector<uint64_t> filled(starts.begin(), starts.end() - 1);
+		codes[chunk].resize(found.size());
+		for (uint64_t code : found) {
+			codes[chunk][filled[partition_of(code)]++] = code;
+		}
+	});
+
+	// Dédoublonnage et comptage : chaque partition n'est modifiée que par un seul thread, blocs pris dans l'ordre
+	pool.parallel_for(0, total, 1, [&](size_t begin, size_t end) {
+		for (size_t p = begin; p < end; ++p) {
+			for (size_t chunk = 0; chunk < chunks; ++chunk) {
+				for (uint64_t i = offsets[chunk][p]; i < offsets[chunk][p + 1]; ++i) {
+					insert(this->partitions[p], codes[chunk][i]);
+				}
+			}
+		}
+	});
+
+	// Les k-mers contenant une base N, rares, sont comptés à la suite
+	size_t cpt = 0;
+	for (size_t chunk = 0; chunk < chunks; ++chunk) {
+		for (std::string_view kmer : others[chunk]) {
+			this->insert_other(kmer);
+		}
+		cpt += generated[chunk];
+	}
+
+	// Retourner le nombre de k-mers générés
+	return cpt;
+}
+
+size_t PackedKmerSet::size() const {
+	size_t total = this->others.size();
+	for (const Partition& partition : this->partitions) {
+		total += partition.size;
+	}
+	return total;
+}
+
+std::vector<uint64_t> PackedKmerSet::histogram(size_t max_count) const {
+	std::vector<uint64_t> histogram(max_count + 1, 0);
+	auto add = [&](uint32_t count) { histogram[std::min<size_t>(count, max_count)]++; };
+	for (const Partition& partition : this->partitions) {
+		for (size_t slot = 0; slot < partition.slots.size(); ++slot) {
+			if (partition.slots[slot] != EMPTY) {
+				add(partition.counts[slot]);
+			}
+		}
+		if (partition.empty_count > 0) {
+			add(partition.empty_count);
+		}
+
+		// Les k-mers notés dans le filtre mais jamais entrés dans la table n'ont été vus qu'une fois
+		// (aux faux positifs du filtre près)
+		if (partition.first_sightings > partition.size) {
+			histogram[std::min<size_t>(1, max_count)] += partition.first_sightings - partition.size;
+		}
+	}
+	for (const auto& [kmer, count] : this->others) {
+		add(count);
+	}
+	return histogram;
+}
+
+void PackedKmerSet::store(ReadStore& reads, uint32_t min_count) const {
+	for (const Partition& partition : this->partitions) {
+		for (size_t slot = 0; slot < partition.slots.size(); ++slot) {
+			if (partition.slots[slot] != EMPTY && partition.counts[slot] >= min_count) {
+				reads.add_packed(partition.slots[slot], this->k);
+			}
+		}
+		if (partition.empty_count > 0 && partition.empty_count >= min_count) {
+			reads.add_packed(EMPTY, this->k);
+		}
+	}
+	for (const auto& [kmer, count] : this->others) {
+		if (count >= min_count) {
+			reads.add(kmer);
+		}
+	}
+}
+
+size_t PackedKmerSet::memory() const {
+	size_t total = 0;
+	for (const Partition& partition : this->partitions) {
+		total += partition.slots.capacity() * sizeof(uint64_t) + partition.counts.capacity() * sizeof(uint32_t) + partition.filter.capacity() * sizeof(uint64_t);
+	}
+	return total;
+}
@@ -0,0 +1,104 @@
+#include "../include/PrefixIndex.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Base du hachage polynomial des fragments
+static const uint64_t HASH_BASE = 0x100000001B3ULL;
+
+// Code d'une base pour le hachage, les bases N sont distinguées des A
+static uint64_t hash_code(char base) {
+	return (base == 'N') ? 5 : ReadStore::encode(base) + 1;
+}
+
+uint64_t PrefixIndex::key(uint64_t fingerprint, size_t length) {
+	// Mélanger l'empreinte et la longueur
+	return splitmix64(fingerprint + length * 0x9E3779B97F4A7C15ULL);
+}
+
+PrefixIndex::PrefixIndex(const ReadStore& reads, const std::vector<int32_t>& nodes) : reads(reads) {
+	// Déterminer la taille de l'index et la longueur maximale des séquences
+	size_t total = 0;
+	size_t max_length = 0;
+	for (int32_t id : nodes) {
+		total += reads.length(id);
+		max_length = std::max(max_length, reads.length(id));
+	}
+
+	// Précalculer les puissances de la base du hachage
+	this->powers.assign(max_length + 1, 1);
+	for (size_t i = 1; i <= max_length; ++i) {
+		this->powers[i] = this->powers[i - 1] * HASH_BASE;
+	}
+
+	// Calculer l'empreinte de chaque préfixe de chaque séquence, de proche en proche
+	std::vector<std::pair<uint64_t, int32_t>> entries;
+	entries.reserve(total);
+	for (int32_t id : nodes) {
+		uint64_t fingerprint = 0;
+		for (size_t pos = 0; pos < reads.length(id); ++pos) {
+			fingerprint = fingerprint * HASH_BASE + hash_code(reads.base(id, pos));
+			entries.emplace_back(key(fingerprint, pos + 1), id);
+		}
+	}
+
+	// Trier les entrées par clé, puis par identifiant pour garder le premier successeur en cas d'égalité
+	std::sort(entries.begin(), entries.end());
+
+	// Répertoire des entrées selon les bits de poids fort de la clé
+	int bits = 1;
+	while ((size_t(1) << bits) < entries.size() && bits < 32) {
+		bits++;
+	}
+	this->shift = 64 - bits;
+	this->directory.assign((size_t(1) << bits) + 1, 0);
+	for (const auto& entry : entries) {
+		this->directory[(entry.first >> this->shift) + 1]++;
+	}
+	for (size_t i = 1; i < this->directory.size(); ++i) {
+		this->directory[i] += this->directory[i - 1];
+	}
+
+	// Stocker les clés et les identifiants dans deux tableaux parallèles
+	this->keys.reserve(entries.size());
+	this->ids.reserve(entries.size());
+	for (const auto& entry : entries) {
+		this->keys.push_back(entry.first);
+		this->ids.push_back(entry.second);
+	}
+}
+
+Overlap PrefixIndex::best_overlap(size_t id, int min_overlap) const {
+	const size_t length = this->reads.length(id);
+
+	// Empreintes des préfixes de la séquence, pour obtenir celle de chaque suffixe en temps constant
+	// (tampon propre à chaque thread, réutilisé d'une séquence à l'autre)
+	thread_local std::vector<uint64_t> prefix;
+	prefix.assign(length + 1, 0);
+	for (size_t pos = 0; pos < length; ++pos) {
+		prefix[pos + 1] = prefix[pos] * HASH_BASE + hash_code(this->reads.base(id, pos));
+	}
+
+	// Sonder l'index avec les suffixes, du plus long au plus court : le premier candidat vérifié est le meilleur
+	const size_t minimum = std::max(1, min_overlap);
+	for (size_t overlap = std::min(length, this->powers.size() - 1); overlap >= minimum; --overlap) {
+		const uint64_t fingerprint = prefix[length] - prefix[length - overlap] * this->powers[overlap];
+		const uint64_t k = key(fingerprint, overlap);
+
+		const uint64_t bucket = k >> this->shift;
+		for (uint64_t entry = this->directory[bucket]; entry < this->directory[bucket + 1] && this->keys[entry] <= k; ++entry) {
+			if (this->keys[entry] != k || this->ids[entry] == static_cast<int32_t>(id)) {
+				continue;
+			}
+
+			// Vérifier le candidat base par base, pour écarter les collisions
+			if (this->reads.equal(id, length - overlap, this->ids[entry], 0, overlap)) {
+				return {this->ids[entry], static_cast<int32_t>(overlap)};
+			}
+		}
+	}
+
+	// Aucun chevauchement trouvé
+	return {-1, 0};
+}
@@ -0,0 +1,182 @@
+#include "../include/ReadStore.hpp"
+#include "../include/OverlapKernel.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+uint64_t ReadStore::encode(char base) {
+	switch (base) {
+		case 'C': case 'c': return 1;
+		case 'G': case 'g': return 2;
+		case 'T': case 't': return 3;
+		default: return 0;
+	}
+}
+
+size_t ReadStore::add(std::string_view sequence) {
+	// Position globale de la première base de la séquence
+	const uint64_t start = this->offsets.back();
+	const uint64_t total = start + sequence.length();
+
+	// Agrandir le tampon, en gardant un mot de marge pour la lecture de 32 bases à cheval sur deux mots
+	this->words.resize(((total + 31) >> 5) + 1, 0);
+
+	// Encoder les bases sur 2 bits et mémoriser la position des bases N
+	for (size_t i = 0; i < sequence.length(); ++i) {
+		const uint64_t global = start + i;
+		const uint64_t code = encode(sequence[i]);
+		this->words[global >> 5] |= code << ((global & 31) * 2);
+
+		if (code == 0 && sequence[i] != 'A' && sequence[i] != 'a') {
+			this->n_positions.push_back(global);
+		}
+	}
+
+	// Mettre à jour la table des débuts de séquences
+	this->offsets.push_back(total);
+	this->n_offsets.push_back(this->n_positions.size());
+
+	// Retourner l'identifiant de la séquence ajoutée
+	return this->offsets.size() - 2;
+}
+
+size_t ReadStore::add_packed(uint64_t bases, size_t length) {
+	// Position globale de la première base de la séquence
+	const uint64_t start = this->offsets.back();
+	const uint64_t total = start + length;
+
+	// Agrandir le tampon, en gardant un mot de marge pour la lecture de 32 bases à cheval sur deux mots
+	this->words.resize(((total + 31) >> 5) + 1, 0);
+
+	// Copier les bases, éventuellement à cheval sur deux mots
+	if (length < 32) {
+		bases &= (uint64_t(1) << (2 * length)) - 1;
+	}
+	const size_t shift = (start & 31) * 2;
+	this->words[start >> 5] |= bases << shift;
+	if (shift != 0) {
+		this->words[(start >> 5) + 1] |= bases >> (64 - shift);
+	}
+
+	// Mettre à jour la table des débuts de séquences
+	this->offsets.push_back(total);
+	this->n_offsets.push_back(this->n_positions.size());
+
+	// Retourner l'identifiant de la séquence ajoutée
+	return this->offsets.size() - 2;
+}
+
+size_t ReadStore::size() const {
+	return this->offsets.size() - 1;
+}
+
+size_t ReadStore::length(size_t id) const {
+	return this->offsets[id + 1] - this->offsets[id];
+}
+
+bool ReadStore::has_n(size_t id) const {
+	return this->n_offsets[id] != this->n_offsets[id + 1];
+}
+
+char ReadStore::base(size_t id, size_t pos) const {
+	const uint64_t global = this->offsets[id] + pos;
+
+	// Vérifier si la base est une base N
+	if (this->has_n(id) && std::binary_search(this->n_positions.begin() + this->n_offsets[id], this->n_positions.begin() + this->n_offsets[id + 1], global)) {
+		return 'N';
+	}
+
+	// Décoder la base
+	return "ACGT"[(this->words[global >> 5] >> ((global & 31) * 2)) & 3];
+}
+
+uint64_t ReadStore::word(size_t id, size_t pos) const {
+	const uint64_t global = this->offsets[id] + pos;
+	const uint64_t shift = (global & 31) * 2;
+
+	// Assembler les 32 bases à partir de deux mots consécutifs si besoin
+	uint64_t result = this->words[global >> 5] >> shift;
+	if (shift != 0) {
+		result |= this->words[(global >> 5) + 1] << (64 - shift);
+	}
+	return result;
+}
+
+bool ReadStore::equal(size_t id1, size_t pos1, size_t id2, size_t pos2, size_t length) const {
+	// Comparer les bases compactées avec le noyau vectorisé choisi pour le processeur
+	if (!packed_equal(this->words.data(), this->offsets[id1] + pos1, this->offsets[id2] + pos2, length)) {
+		return false;
+	}
+
+	// Les bases N sont codées comme des A, leurs positions doivent donc aussi coïncider
+	if (!this->has_n(id1) && !this->has_n(id2)) {
+		return true;
+	}
+	const uint64_t start1 = this->offsets[id1] + pos1;
+	const uint64_t start2 = this->offsets[id2] + pos2;
+	auto it1 = std::lower_bound(this->n_positions.begin() + this->n_offsets[id1], this->n_positions.begin() + this->n_offsets[id1 + 1], start1);
+	auto it2 = std::lower_bound(this->n_positions.begin() + this->n_offsets[id2], this->n_positions.begin() + this->n_offsets[id2 + 1], start2);
+	auto end1 = std::lower_bound(it1, this->n_positions.begin() + this->n_offsets[id1 + 1], start1 + length);
+	auto end2 = std::lower_bound(it2, this->n_positions.begin() + this->n_offsets[id2 + 1], start2 + length);
+
+	// Comparer les positions relatives des bases N dans les deux fragments
+	if (end1 - it1 != end2 - it2) {
+		return false;
+	}
+	for (; it1 != end1; ++it1, ++it2) {
+		if (*it1 - start1 != *it2 - start2) {
+			return false;
+		}
+	}
+	return true;
+}
+
+uint64_t ReadStore::hash(size_t id) const {
+	const size_t length = this->length(id);
+
+	// Mélanger les bases 32 par 32, en partant de la longueur
+	uint64_t result = length;
+	for (size_t done = 0; done < length; done += 32) {
+		const size_t count = std::min<size_t>(32, length - done);
+		const uint64_t mask = (count == 32) ? ~uint64_t(0) : ((uint64_t(1) << (2 * count)) - 1);
+		result = (result ^ (this->word(id, done) & mask)) * 0x9E3779B97F4A7C15ULL;
+		result ^= result >> 32;
+	}
+	return result;
+}
+
+void ReadStore::decode(size_t id, size_t pos, std::string& out) const {
+	const size_t length = this->length(id);
+	const size_t start = out.length();
+	out.resize(start + (length - pos));
+
+	// Décoder les bases 32 par 32
+	for (size_t done = pos; done < length; done += 32) {
+		const size_t count = std::min<size_t>(32, length - done);
+		uint64_t bases = this->word(id, done);
+		for (size_t i = 0; i < count; ++i) {
+			out[start + (done - pos) + i] = "ACGT"[bases & 3];
+			bases >>= 2;
+		}
+	}
+
+	// Rétablir les bases N
+	const uint64_t first = this->offsets[id] + pos;
+	auto end = this->n_positions.begin() + this->n_offsets[id + 1];
+	for (auto it = std::lower_bound(this->n_positions.begin() + this->n_offsets[id], end, first); it != end; ++it) {
+		out[start + (*it - first)] = 'N';
+	}
+}
+
+std::string ReadStore::get(size_t id) const {
+	// Décoder toute la séquence
+	std::string sequence;
+	this->decode(id, 0, sequence);
+	return sequence;
+}
+
+size_t ReadStore::memory() const {
+	return this->words.capacity() * sizeof(uint64_t) + this->offsets.capacity() * sizeof(uint64_t) + this->n_positions.capacity() * sizeof(uint64_t) + this->n_offsets.capacity() * sizeof(uint32_t);
+}
@@ -0,0 +1,144 @@
+#include "../include/ThreadPool.hpp"
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+ThreadPool::ThreadPool(size_t threads) {
+	// Utiliser tous les cœurs disponibles si le nombre de threads n'est pas précisé
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// Créer une file de tâches par thread avant de démarrer les threads
+	for (size_t i = 0; i < threads; ++i) {
+		this->queues.push_back(std::make_unique<TaskQueue>());
+	}
+	for (size_t i = 0; i < threads; ++i) {
+		this->workers.emplace_back(&ThreadPool::worker_loop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	// Signaler l'arrêt aux threads, qui terminent d'abord les tâches en attente
+	{
+		std::lock_guard<std::mutex> lock(this->state_mutex);
+		this->stopping = true;
+	}
+	this->work_available.notify_all();
+
+	// Attendre la fin des threads
+	for (std::thread& worker : this->workers) {
+		worker.join();
+	}
+}
+
+size_t ThreadPool::size() const {
+	return this->workers.size();
+}
+
+bool ThreadPool::pop_task(size_t index, std::function<void()>& task) {
+	// Parcourir la file du thread, puis celles des autres threads
+	for (size_t i = 0; i < this->queues.size(); ++i) {
+		TaskQueue& queue = *this->queues[(index + i) % this->queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty()) {
+			continue;
+		}
+
+		// Sa propre file se vide par la fin, les autres sont volées par le début
+		if (i == 0) {
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+		} else {
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+		}
+
+		std::lock_guard<std::mutex> state_lock(this->state_mutex);
+		this->queued--;
+		return true;
+	}
+	return false;
+}
+
+void ThreadPool::worker_loop(size_t index) {
+	while (true) {
+		// Exécuter une tâche si possible, en gardant la première exception levée pour la relancer dans wait()
+		std::function<void()> task;
+		if (this->pop_task(index, task)) {
+			std::exception_ptr error;
+			try {
+				task();
+			} catch (...) {
+				error = std::current_exception();
+			}
+
+			// Signaler la fin de la dernière tâche en attente
+			std::lock_guard<std::mutex> lock(this->state_mutex);
+			if (error && !this->error) {
+				this->error = error;
+			}
+			if (--this->pending == 0) {
+				this->work_done.notify_all();
+			}
+			continue;
+		}
+
+		// Attendre qu'une tâche soit soumise ou que le groupe soit arrêté
+		std::unique_lock<std::mutex> lock(this->state_mutex);
+		this->work_available.wait(lock, [this]() { return this->stopping || this->queued > 0; });
+		if (this->stopping && this->queued == 0) {
+			return;
+		}
+	}
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+	// Choisir la file suivante à tour de rôle et compter la tâche comme non terminée
+	size_t index;
+	{
+		std::lock_guard<std::mutex> lock(this->state_mutex);
+		index = this->next_queue;
+		this->next_queue = (this->next_queue + 1) % this->queues.size();
+		this->pending++;
+	}
+
+	// Ajouter la tâche à la file choisie, puis la compter comme disponible avant qu'un thread puisse la prendre
+	{
+		std::lock_guard<std::mutex> lock(this->queues[index]->mutex);
+		this->queues[index]->tasks.push_back(std::move(task));
+		std::lock_guard<std::mutex> state_lock(this->state_mutex);
+		this->queued++;
+	}
+
+	// Réveiller un thread
+	this->work_available.notify_one();
+}
+
+void ThreadPool::wait() {
+	std::unique_lock<std::mutex> lock(this->state_mutex);
+	this->work_done.wait(lock, [this]() { return this->pending == 0; });
+
+	// Relancer la première exception levée par une tâche
+	if (this->error) {
+		std::exception_ptr error = std::move(this->error);
+		this->error = nullptr;
+		std::rethrow_exception(error);
+	}
+}
+
+void ThreadPool::parallel_for(size_t begin, size_t end, size_t chunk, const std::function<void(size_t, size_t)>& body) {
+	// Soumettre un bloc par tâche
+	chunk = std::max<size_t>(chunk, 1);
+	for (size_t start = begin; start < end; start += chunk) {
+		const size_t stop = std::min(end, start + chunk);
+		this->submit([&body, start, stop]() { body(start, stop); });
+	}
+
+	// Attendre la fin de tous les blocs
+	this->wait();
+}
@@ -1,158 +1,173 @@
 #include "../include/config.hpp"
+#include "../include/FastqStream.hpp"
+#include "../include/ReadStore.hpp"
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <unordered_set>
-
-std::vector<std::string> read_fastq(const std::string& filename) {
-	// Ouvrir le fichier FASTQ en mode lecture
-	std::ifstream fastq(filename);
-
-	// Vérifier si le fichier est ouvert avec succès
+#include <functional>
+#include <algorithm>
+#include <span>
+#include <filesystem>
+#include <system_error>
+
+void stream_fastq(const std::string& filename, std::size_t buffer_size, const std::function<void(const std::vector<std::string_view>&)>& consumer) {
+	// Ouvrir le fichier FASTQ pour une lecture par blocs
+	FastqStream fastq(filename, buffer_size);
 	if (!fastq.is_open()) {
-		std::cerr << "Erreur d'ouverture du fichier FASTQ." << std::endl;
-		// Retourner un vecteur vide en cas d'erreur
-		return std::vector<std::string>();
-	}
-
-	// Lire toutes les lignes du fichier FASTQ
-	std::vector<std::string> lines;
-	std::string line;
-	while (std::getline(fastq, line)) {
-		lines.push_back(line);
+		return;
 	}
 
 	// Initialiser l'itérateur de comptage
-	int cpt = 1;
+	size_t cpt = 0;
 
-	// Extraire les séquences
-	std::vector<std::string> sequences;
-	for (size_t idx = 1; idx < lines.size(); idx += 4) {
-		sequences.push_back(lines[idx]);
+	// Transmettre chaque lot de séquences à l'étape suivante dès qu'il est lu
+	std::vector<std::string_view> batch;
+	while (fastq.next_batch(batch)) {
+		if (batch.empty()) {
+			continue;
+		}
+		consumer(batch);
 
 		// Affichage de la progression
+		cpt += batch.size();
 		std::cout << "\rNombre de reads récupérés : [" << cpt << "]" << std::flush;
-		cpt++;
 	}
 
 	// Faire le saut de ligne
 	std::cout << std::endl;
-
-	// Fermer le fichier FASTQ
-	fastq.close();
-
-	// Retourner le vecteur des séquences
-	return sequences;
 }
 
-std::vector<std::string> kmerisation(const std::vector<std::string>& sequences, int k) {
-	// Fonction locale pour générer les k-mers à partir d'une séquence
-	auto generate_kmers = [](const std::string& sequence, int k) -> std::vector<std::string> {
-		std::vector<std::string> kmers;
-		for (size_t i = 0; i <= sequence.length() - k; ++i) {
-			kmers.push_back(sequence.substr(i, k));
-		}
-		return kmers;
-	};
-
-	// Initialiser l'itérateur de comptage
-	int cpt = 0;
-
-	// Utilise une approche de compréhension de liste pour générer tous les k-mers uniques
-	std::unordered_set<std::string> kmer_set;
-	for (const auto& sequence : sequences) {
-		auto kmers = generate_kmers(sequence, k);
-		kmer_set.insert(kmers.begin(), kmers.end());
-
-		// Affichage de la progression
-		cpt += kmers.size();
-		std::cout << "\rNombre de " << k << "-mers crées : [" << cpt << "]" << std::flush;
+uint64_t estimate_kmers(const std::string& filename, std::size_t buffer_size, int k) {
+	std::error_code error;
+	const uintmax_t file_size = std::filesystem::file_size(filename, error);
+	if (error) {
+		return 0;
 	}
-	
-	// Faire le saut de ligne
-	std::cout << std::endl;
 
-	// Convertit l'ensemble de k-mers en liste
-	std::vector<std::string> kmer_list(kmer_set.begin(), kmer_set.end());
+	// Lire le premier bloc du fichier
+	FastqStream fastq(filename, buffer_size);
+	std::vector<std::string_view> batch;
+	while (fastq.is_open() && batch.empty() && fastq.next_batch(batch)) {
+	}
+	if (batch.size() < 2) {
+		return file_size / 2;
+	}
 
-	// Affichage du nombre de k-mers crées
-	std::cout << "\rNombre de " << k << "-mers uniques : [" << kmer_list.size() << "]" << std::endl;
+	// Les séquences d'un lot se suivent dans le tampon : l'écart entre la première et la dernière couvre un enregistrement par read
+	const uint64_t record_size = (batch.back().data() - batch.front().data()) / (batch.size() - 1);
+	uint64_t kmers = 0;
+	for (std::string_view sequence : batch) {
+		kmers += (sequence.length() >= static_cast<size_t>(k)) ? sequence.length() - k + 1 : 0;
+	}
+	return file_size / std::max<uint64_t>(1, record_size) * kmers / batch.size();
+}
 
-	// Retourne la liste de k-mers uniques
-	return kmer_list;
+size_t KmerHash::operator()(std::string_view kmer) const {
+	return std::hash<std::string_view>{}(kmer);
 }
 
-int compute_overlap(const std::string& seq1, const std::string& seq2) {
-	// Fusionne les deux séquences avec un caractère spécial '$'
-	std::string seq_merged = seq2 + '$' + seq1;
+size_t add_kmers(std::string_view sequence, int k, KmerCounts& kmer_counts) {
+	// Générer les k-mers de la séquence et n'allouer que ceux qui sont nouveaux
+	size_t cpt = 0;
+	for (size_t i = 0; i + k <= sequence.length(); ++i) {
+		std::string_view kmer = sequence.substr(i, k);
+		auto it = kmer_counts.find(kmer);
+		if (it == kmer_counts.end()) {
+			kmer_counts.emplace(kmer, 1);
+		} else {
+			it->second++;
+		}
+		cpt++;
+	}
 
-	// Obtient la longueur des deux séquences
-	int length_seq1 = seq1.length();
-	int length_seq2 = seq2.length();
+	// Retourner le nombre de k-mers générés
+	return cpt;
+}
 
-	// Vérifie si l'une des séquences est vide, dans ce cas, le chevauchement est nul
-	if (length_seq1 == 0 || length_seq2 == 0) {
-		return 0;
+void print_kmer_spectrum(const std::vector<uint64_t>& histogram, int k, bool estimated_singletons) {
+	// Une ligne par nombre d'occurrences présent, la dernière regroupant les occurrences supérieures
+	std::cout << "Spectre des " << k << "-mers (occurrences : k-mers distincts) :" << std::endl;
+	for (size_t count = 1; count < histogram.size(); ++count) {
+		if (histogram[count] == 0) {
+			continue;
+		}
+		std::cout << "\t" << ((count + 1 == histogram.size()) ? "⩾ " : "") << count << " : [" << ((count == 1 && estimated_singletons) ? "≈ " : "") << histogram[count] << "]" << std::endl;
 	}
+}
 
-	// Initialise les indices pour le chevauchement
-	int n = length_seq1 + length_seq2 + 1;
-	int end_suffix = n - 1;
-	int end_prefix = length_seq2 - 1;
-
-	// Parcourt les séquences pour trouver le chevauchement maximal
-	while (end_prefix >= 0) {
-		if (seq_merged[end_prefix] == seq_merged[end_suffix]) {
-			end_suffix--;
-			end_prefix--;
-		} else {
-			// En cas de mismatch, ajuste les indices
-			if (end_suffix != n - 1) {
-				end_suffix = n - 1;
-			} else {
-				end_prefix--;
-			}
+int compute_overlap(const ReadStore& reads, size_t id1, size_t id2, int min_overlap) {
+	// Obtient la longueur des deux séquences
+	const size_t length_seq1 = reads.length(id1);
+	const size_t length_seq2 = reads.length(id2);
+
+	// Teste les longueurs candidates de la plus grande à la plus petite : les 32 premières bases sont comparées en un mot,
+	// et seuls les candidats qui les partagent sont vérifiés en entier par le noyau vectorisé
+	const size_t minimum = std::max(1, min_overlap);
+	const uint64_t prefix = reads.word(id2, 0);
+	for (size_t overlap = std::min(length_seq1, length_seq2); overlap >= minimum; --overlap) {
+		const uint64_t mask = (overlap >= 32) ? ~uint64_t(0) : ((uint64_t(1) << (2 * overlap)) - 1);
+		if (((reads.word(id1, length_seq1 - overlap) ^ prefix) & mask) == 0 && reads.equal(id1, length_seq1 - overlap, id2, 0, overlap)) {
+			return overlap;
 		}
 	}
 
-	// Calcule et retourne la longueur du chevauchement maximal
-	return n - end_suffix - 1;
+	// Aucun chevauchement
+	return 0;
 }
 
-std::vector<std::string> calculate_overlap(const std::string& seq1, const std::vector<std::string>& sequences) {
-	// Initialise les variables pour le score et le meilleur score
-	int score = 0;
-	int best_score = 0;
-
-	// Initialise la liste pour stocker le meilleur chevauchement et le score associé
-	std::vector<std::string> result_tuple{"", "0"};
-	std::string seq2 = "";
-
-	// Parcourt toutes les séquences dans la liste
-	for (const auto& seq2 : sequences) {
-		// Vérifie que la séquence n'est pas la même que la séquence de référence
-		if (seq1 != seq2) {
-			// Calcule le score de chevauchement avec la séquence de référence
-			score = compute_overlap(seq1, seq2);
-
-			// Met à jour le meilleur score et le meilleur chevauchement si le score actuel est supérieur
-			if (score > best_score) {
-				best_score = score;
-				result_tuple[0] = seq2;
-				result_tuple[1] = std::to_string(best_score);
-			}
+// Nombre de bases des candidats d'une tuile : 64 Ki bases, soit 16 Kio compactés, tiennent dans le cache L1/L2
+static const size_t TILE_BASES = 64 * 1024;
+
+void calculate_overlaps(const ReadStore& reads, std::span<const int32_t> queries, const std::vector<int32_t>& candidates, int min_overlap, std::span<Overlap> results) {
+	// Séquences du bloc encore à comparer : une séquence plus courte que le minimum n'a aucun chevauchement possible
+	std::vector<size_t> active;
+	for (size_t i = 0; i < queries.size(); ++i) {
+		results[i] = {-1, 0};
+		if (static_cast<int>(reads.length(queries[i])) >= min_overlap) {
+			active.push_back(i);
 		}
 	}
 
-	// Retourne la liste contenant le meilleur chevauchement et le score associé
-	return result_tuple;
-}
+	// Parcourir les candidats par tuiles, dans l'ordre pour garder le premier successeur en cas d'égalité
+	for (size_t tile_begin = 0; tile_begin < candidates.size() && !active.empty();) {
+		size_t tile_end = tile_begin;
+		size_t tile_bases = 0;
+		while (tile_end < candidates.size() && (tile_end == tile_begin || tile_bases < TILE_BASES)) {
+			tile_bases += reads.length(candidates[tile_end]);
+			tile_end++;
+		}
 
-std::string concat_sequences(const std::string& seq1, const std::string& seq2, int score) {
-	// Concaténer la séquence 1 avec la séquence 2 à partir de l'indice spécifié par le score
-	std::string result_sequence = seq1 + seq2.substr(score);
+		// Comparer la tuile à chaque séquence du bloc encore active
+		for (size_t i : active) {
+			const int32_t id = queries[i];
+			const size_t length = reads.length(id);
+			Overlap& best = results[i];
+			for (size_t c = tile_begin; c < tile_end && static_cast<size_t>(best.score) < length; ++c) {
+				const int32_t other = candidates[c];
+
+				// Seul un chevauchement plus long que le meilleur courant peut le remplacer
+				const int minimum = std::max(min_overlap, best.score + 1);
+				if (static_cast<int>(reads.length(other)) < minimum) {
+					continue;
+				}
+
+				// Vérifie que la séquence n'est pas la même que la séquence de référence
+				if (reads.length(other) == length && reads.equal(id, 0, other, 0, length)) {
+					continue;
+				}
+
+				const int score = compute_overlap(reads, id, other, minimum);
+				if (score > best.score) {
+					best = {other, score};
+				}
+			}
+		}
 
-	// Retourner la séquence résultante
-	return result_sequence;
+		// Retirer les séquences ayant atteint leur chevauchement maximal possible
+		std::erase_if(active, [&](size_t i) { return static_cast<size_t>(results[i].score) >= reads.length(queries[i]); });
+		tile_begin = tile_end;
+	}
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #include "../include/config.hpp"
 #include "../include/OverlapAssembler.hpp"
+#include "../include/DiskKmerCounter.hpp"
 #include "../include/cxxopts.hpp"
+#include <exception>
 #include <iostream>
+#include <optional>
 #include <string>
 #include <chrono>
 
@@ -14,6 +17,18 @@ int main(int argc, char* argv[]) {
 		("s,seuil", "Le score de chevauchement minimum pour garder un nœud dans le graphe.", cxxopts::value<int>()->default_value("10"))
 		("f,fasta", "Nom du fichier fasta qui contiendra les contigs.", cxxopts::value<std::string>())
 		("m,min_length", "Longueur minimum d'un contig pour être garder.", cxxopts::value<int>()->default_value("0"))
+		("b,buffer_size", "Taille (en octets) du tampon pour lire le fichier fastq en flux (0 : fichier projeté en entier).", cxxopts::value<size_t>()->default_value("0"))
+		("e,engine", "Moteur de chevauchement : hash (empreintes des préfixes), fm (index FM), minimizer (graines de minimiseurs, reads longs) ou brute (toutes les paires).", cxxopts::value<std::string>()->default_value("hash"))
+		("K,minimizer_k", "Longueur des k-mers des minimiseurs (moteur minimizer, de 1 à 31).", cxxopts::value<int>()->default_value("15"))
+		("W,minimizer_w", "Nombre de k-mers consécutifs d'une fenêtre des minimiseurs (moteur minimizer).", cxxopts::value<int>()->default_value("10"))
+		("S,min_seeds", "Nombre minimal de minimiseurs partagés sur une même diagonale pour vérifier un candidat (moteur minimizer, 0 : déduit du seuil).", cxxopts::value<int>()->default_value("0"))
+		("n,min_kmer_count", "Nombre minimal d'occurrences d'un k-mer pour le garder (k-mer solide).", cxxopts::value<uint32_t>()->default_value("1"))
+		("B,bloom_filter", "Note la première occurrence des k-mers dans un filtre de Bloom quand au moins 2 occurrences sont demandées (moins de mémoire, comptage approché).")
+		("x,max_mem", "Budget de mémoire (en octets) du comptage des k-mers, compté partition par partition depuis le disque (0 : tout en mémoire).", cxxopts::value<size_t>()->default_value("0"))
+		("t,threads", "Nombre de threads à utiliser (0 : tous les cœurs disponibles).", cxxopts::value<size_t>()->default_value("1"))
+		("c,containment", "Moteur de retrait des contigs contenus : fm (index FM) ou ac (automate d'Aho-Corasick).", cxxopts::value<std::string>()->default_value("fm"))
+		("d,drop_contained", "Retire les reads en double ou contenus dans un autre read avant de créer le graphe.")
+		("r,release_reads", "Libère les séquences d'entrée dès qu'elles ne servent plus.")
 		("h,help", "Affiche l'aide.");
 	auto result = options.parse(argc, argv);
 
@@ -29,6 +44,53 @@ int main(int argc, char* argv[]) {
 	int seuil = result["seuil"].as<int>();
 	std::string fasta = result["fasta"].as<std::string>();
 	int min_length = result["min_length"].as<int>();
+	size_t buffer_size = result["buffer_size"].as<size_t>();
+	std::string engine = result["engine"].as<std::string>();
+	int minimizer_k = result["minimizer_k"].as<int>();
+	int minimizer_w = result["minimizer_w"].as<int>();
+	int min_seeds = result["min_seeds"].as<int>();
+	uint32_t min_kmer_count = result["min_kmer_count"].as<uint32_t>();
+	size_t max_mem = result["max_mem"].as<size_t>();
+	bool bloom_filter = result.count("bloom_filter") > 0;
+	size_t threads = result["threads"].as<size_t>();
+	std::string containment = result["containment"].as<std::string>();
+	bool drop_contained = result.count("drop_contained") > 0;
+	bool release_reads = result.count("release_reads") > 0;
+
+	// Vérifie le moteur de chevauchement
+	if (engine != "hash" && engine != "fm" && engine != "minimizer" && engine != "brute") {
+		std::cerr << "Moteur de chevauchement inconnu : " << engine << std::endl;
+		return 1;
+	}
+
+	// Vérifie la longueur des k-mers : -1 (reads entiers) ou au moins 1
+	if (kmers_length != -1 && kmers_length < 1) {
+		std::cerr << "Longueur des k-mers invalide : k = " << kmers_length << " (-1 pour les reads entiers, sinon au moins 1)" << std::endl;
+		return 1;
+	}
+
+	// Vérifie les paramètres des minimiseurs
+	if (minimizer_k < 1 || minimizer_k > 31 || minimizer_w < 1 || min_seeds < 0) {
+		std::cerr << "Paramètres des minimiseurs invalides : k = " << minimizer_k << ", w = " << minimizer_w << ", graines = " << min_seeds << std::endl;
+		return 1;
+	}
+
+	// Le comptage sur le disque ne porte que sur les k-mers encodés sur 64 bits
+	if (max_mem > 0 && kmers_length > 32) {
+		std::cerr << "Le budget de mémoire n'est appliqué qu'aux k-mers de longueur ⩽ 32 : comptage en mémoire." << std::endl;
+	}
+
+	// Vérifie que le budget de mémoire couvre au moins un bloc relu et une table vide
+	if (max_mem > 0 && kmers_length != -1 && kmers_length <= 32 && max_mem < DiskKmerCounter::min_memory()) {
+		std::cerr << "Budget de mémoire trop petit : " << max_mem << " octets (au moins " << DiskKmerCounter::min_memory() << " octets pour un bloc relu et une table vide)" << std::endl;
+		return 1;
+	}
+
+	// Vérifie le moteur de retrait des contigs contenus
+	if (containment != "fm" && containment != "ac") {
+		std::cerr << "Moteur de retrait des contigs contenus inconnu : " << containment << std::endl;
+		return 1;
+	}
 	
 	// Démmarrage des traitements
 	std::cout << "\n--- DÉBUT ---" << std::endl;
@@ -36,23 +98,32 @@ int main(int argc, char* argv[]) {
 	// Récupération des séquences à utiliser
 	std::cout << "\n- Récupération des séquences -" << std::endl;
 	auto start_time = std::chrono::high_resolution_clock::now();
-	OverlapAssembler assembler = OverlapAssembler(fastq, kmers_length);
+	// Les erreurs du système de fichiers (comptage des k-mers sur le disque) sont fatales
+	std::optional<OverlapAssembler> assembler;
+	try {
+		assembler.emplace(fastq, kmers_length, buffer_size, threads, min_kmer_count, max_mem, bloom_filter);
+	} catch (const std::exception& error) {
+		std::cerr << "\n" << error.what() << std::endl;
+		return 1;
+	}
 	auto end_time = std::chrono::high_resolution_clock::now();
 	auto duration = std::chrono::duration_cast<std::chrono::seconds>(end_time - start_time);
 	std::cout << "Temps d'exécution : " << duration.count() << " seconds" << std::endl;
 
-	// Création du graphe de chevauchement
-	start_time = std::chrono::high_resolution_clock::now();
-	std::cout << "\n- Création du graphe de chevauchement -" << std::endl;
-	assembler.MakeGraph();
-	end_time = std::chrono::high_resolution_clock::now();
-	duration = std::chrono::duration_cast<std::chrono::seconds>(end_time - start_time);
-	std::cout << "Temps d'exécution : " << duration.count() << " seconds" << std::endl;
+	// Retrait des reads contenus, si demandé
+	if (drop_contained) {
+		start_time = std::chrono::high_resolution_clock::now();
+		std::cout << "\n- Retrait des reads contenus -" << std::endl;
+		assembler->RemoveContainedReads();
+		end_time = std::chrono::high_resolution_clock::now();
+		duration = std::chrono::duration_cast<std::chrono::seconds>(end_time - start_time);
+		std::cout << "Temps d'exécution : " << duration.count() << " seconds" << std::endl;
+	}
 
-	// Nettoyage du graphe
+	// Création du graphe de chevauchement, nettoyé au fur et à mesure selon le seuil
 	start_time = std::chrono::high_resolution_clock::now();
-	std::cout << "\n- Nettoyage du graphe (seuil = " << seuil << ") -" << std::endl;
-	assembler.CleanGraph(seuil);
+	std::cout << "\n- Création du graphe de chevauchement (moteur = " << engine << ", seuil = " << seuil << ") -" << std::endl;
+	assembler->MakeGraph(engine, seuil, minimizer_k, minimizer_w, min_seeds);
 	end_time = std::chrono::high_resolution_clock::now();
 	duration = std::chrono::duration_cast<std::chrono::seconds>(end_time - start_time);
 	std::cout << "Temps d'exécution : " << duration.count() << " seconds" << std::endl;
@@ -60,15 +131,15 @@ int main(int argc, char* argv[]) {
 	// Assemblage des contigs
 	start_time = std::chrono::high_resolution_clock::now();
 	std::cout << "\n- Assemblage des contigs -" << std::endl;
-	assembler.AssembleContigs();
+	assembler->AssembleContigs();
 	end_time = std::chrono::high_resolution_clock::now();
 	duration = std::chrono::duration_cast<std::chrono::seconds>(end_time - start_time);
 	std::cout << "Temps d'exécution : " << duration.count() << " seconds" << std::endl;
 
 	// Vérifier si des séquences sont contenues dans d'autres
 	start_time = std::chrono::high_resolution_clock::now();
-	std::cout << "\n- Retrait des contigs contenus -" << std::endl;
-	assembler.remove_contained_sequences();
+	std::cout << "\n- Retrait des contigs contenus (moteur = " << containment << ") -" << std::endl;
+	assembler->remove_contained_sequences(release_reads, containment);
 	end_time = std::chrono::high_resolution_clock::now();
 	duration = std::chrono::duration_cast<std::chrono::seconds>(end_time - start_time);
 	std::cout << "Temps d'exécution : " << duration.count() << " seconds" << std::endl;
@@ -76,7 +147,7 @@ int main(int argc, char* argv[]) {
 	// Sauvegarder les contigs obtenus
 	start_time = std::chrono::high_resolution_clock::now();
 	std::cout << "\n- Sauvegarde des contigs ⩾ " << min_length << " -" << std::endl;
-	assembler.SaveContigs(fasta, min_length);
+	assembler->SaveContigs(fasta, min_length);
 	end_time = std::chrono::high_resolution_clock::now();
 	duration = std::chrono::duration_cast<std::chrono::seconds>(end_time - start_time);
 	std::cout << "Temps d'exécution : " << duration.count() << " seconds" << std::endl;
@@ -0,0 +1,156 @@
+#!/bin/bash
+# Tests de bout en bout : les moteurs, le nombre de threads et les modes de comptage des k-mers
+# doivent donner les mêmes résultats sur un même jeu de reads.
+
+OLP_ASM="$(cd "$(dirname "$0")/.." && pwd)/olp_asm"
+GENERATOR="$(cd "$(dirname "$0")/.." && pwd)/generator_sequences/generator.py"
+
+# Répertoire de travail, supprimé à la fin
+WORK="$(mktemp -d)"
+trap 'rm -rf "$WORK"' EXIT
+cd "$WORK" || exit 1
+
+failures=0
+
+# Lance olp_asm avec les options données, les contigs étant écrits dans le fichier donné
+run() {
+	local fasta="$1"
+	shift
+	if ! "$OLP_ASM" -q reads.fastq -f "$fasta" "$@" > "$fasta.log" 2>&1; then
+		echo "ÉCHEC : olp_asm $* (code de retour non nul)"
+		failures=$((failures + 1))
+	fi
+}
+
+# Vérifie que deux fichiers sont identiques
+same() {
+	if ! cmp -s "$2" "$3"; then
+		echo "ÉCHEC : $1"
+		failures=$((failures + 1))
+	fi
+}
+
+# Extrait le spectre et les nombres de k-mers uniques et solides d'un journal
+spectrum() {
+	grep -E "^	[0-9]+ : |uniques|solides" "$1.log" > "$1.spectrum"
+}
+
+# Donne le nombre de k-mers solides d'un journal
+solid() {
+	grep "solides" "$1.log" | sed 's/.*\[\([0-9]*\)\].*/\1/'
+}
+
+# Jeu de reads reproductible (graine fixe du générateur)
+python3 "$GENERATOR" -G 1000 -n 1500 -q reads.fastq -f genome.fasta > /dev/null || exit 1
+
+# Contigs de référence : moteur hash, un thread, fichier projeté en mémoire
+run reference.fa
+
+# Lecture en flux, par petits blocs
+run stream.fa -b 4096
+same "lecture en flux (-b) : contigs différents" reference.fa stream.fa
+
+# Moteur des empreintes des préfixes (hash, référence) : mêmes chevauchements que la comparaison de toutes les paires
+run brute.fa -e brute
+same "moteur brute : contigs différents du moteur hash" reference.fa brute.fa
+
+# Moteur de l'index FM
+run fm.fa -e fm
+same "moteur fm : contigs différents du moteur hash" reference.fa fm.fa
+
+# Moteur des graines de minimiseurs, chaque candidat étant vérifié base par base
+# (le nombre de graines déduit du seuil n'écarte aucun chevauchement, quels que soient k et w)
+run minimizer.fa -e minimizer
+same "moteur minimizer : contigs différents du moteur hash" reference.fa minimizer.fa
+run minimizer_small.fa -e minimizer -K 11 -W 5
+same "moteur minimizer (-K 11 -W 5) : contigs différents du moteur hash" reference.fa minimizer_small.fa
+
+# Construction du graphe sur 4 threads : le graphe ne dépend pas du nombre de threads
+for engine in hash fm minimizer brute; do
+	run "${engine}_4.fa" -e "$engine" -t 4
+	same "moteur $engine, 4 threads : contigs différents du moteur hash sur 1 thread" reference.fa "${engine}_4.fa"
+done
+
+# Retrait des contigs contenus par l'automate d'Aho-Corasick : seules les séquences courtes sont cherchées,
+# chaque contig gardé par l'index FM est donc aussi gardé
+run ac.fa -c ac
+if [ -n "$(comm -23 <(grep -v '^>' reference.fa | sort) <(grep -v '^>' ac.fa | sort))" ]; then
+	echo "ÉCHEC : retrait des contigs contenus (-c ac) : contig gardé par l'index FM retiré"
+	failures=$((failures + 1))
+fi
+
+# Retrait des reads contenus avant la construction du graphe, avec chaque moteur et sur 4 threads
+run drop.fa -d
+for options in "-e fm" "-e brute -t 4" "-t 4"; do
+	name="drop_${options// /_}.fa"
+	run "$name" -d $options
+	same "retrait des reads contenus (-d $options) : contigs différents" drop.fa "$name"
+done
+
+# Libération des reads dès que les contigs sont compactés
+run release.fa -r
+same "libération des reads (-r) : contigs différents" reference.fa release.fa
+
+# Assemblage des k-mers encodés sur 64 bits : les moteurs donnent les mêmes contigs
+run kmers_hash.fa -k 21
+for engine in fm brute; do
+	run "kmers_$engine.fa" -k 21 -e "$engine"
+	same "k-mers (-k 21), moteur $engine : contigs différents du moteur hash" kmers_hash.fa "kmers_$engine.fa"
+done
+
+# Comptage des k-mers en parallèle : les mêmes contigs sur 4 threads
+run kmers_4.fa -k 21 -t 4
+same "k-mers (-k 21), 4 threads : contigs différents" kmers_hash.fa kmers_4.fa
+
+# Une longueur de k-mers nulle ou négative (hormis -1) est refusée
+for k in 0 -2; do
+	if "$OLP_ASM" -q reads.fastq -f invalid.fa -k "$k" > invalid.log 2>&1; then
+		echo "ÉCHEC : longueur de k-mers invalide (-k $k) acceptée"
+		failures=$((failures + 1))
+	fi
+done
+
+# k-mers solides (au moins 2 occurrences) : même spectre et mêmes contigs sur 4 threads
+run memory.fa -k 21 -n 2
+spectrum memory.fa
+run memory_4.fa -k 21 -n 2 -t 4
+spectrum memory_4.fa
+same "k-mers solides (-n 2), 4 threads : spectre différent" memory.fa.spectrum memory_4.fa.spectrum
+same "k-mers solides (-n 2), 4 threads : contigs différents" memory.fa memory_4.fa
+if [ "$(solid memory.fa)" -ge "$(solid kmers_hash.fa)" ]; then
+	echo "ÉCHEC : k-mers solides (-n 2) : aucun k-mer rare retiré"
+	failures=$((failures + 1))
+fi
+
+# Budget de mémoire minimal du comptage sur le disque (DiskKmerCounter::min_memory)
+MIN_MEM=352256
+
+# Comptage des k-mers solides sur le disque (plusieurs passes), en parallèle et en flux
+for options in "-x $MIN_MEM" "-x $MIN_MEM -t 4" "-x $MIN_MEM -b 4096" "-x 1000000"; do
+	name="kmers_${options// /_}.fa"
+	run "$name" -k 21 -n 2 $options
+	spectrum "$name"
+	same "comptage des k-mers ($options) : spectre différent du comptage en mémoire" memory.fa.spectrum "$name.spectrum"
+done
+
+# Un budget inférieur au minimum est refusé
+if "$OLP_ASM" -q reads.fastq -f invalid.fa -k 21 -x $((MIN_MEM - 1)) > invalid.log 2>&1; then
+	echo "ÉCHEC : budget de mémoire trop petit (-x $((MIN_MEM - 1))) accepté"
+	failures=$((failures + 1))
+fi
+
+# Le filtre de Bloom ne perd aucun k-mer solide
+for options in "-B" "-B -t 4" "-B -x $MIN_MEM"; do
+	name="bloom_${options// /_}.fa"
+	run "$name" -k 21 -n 2 $options
+	if [ "$(solid "$name")" -lt "$(solid memory.fa)" ]; then
+		echo "ÉCHEC : filtre de Bloom ($options) : moins de k-mers solides que le comptage exact"
+		failures=$((failures + 1))
+	fi
+done
+
+if [ "$failures" -gt 0 ]; then
+	echo "$failures vérification(s) échouée(s)"
+	exit 1
+fi
+echo "Tests de bout en bout : OK"
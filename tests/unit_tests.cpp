@@ -0,0 +1,686 @@
+#include "../include/config.hpp"
+#include "../include/AhoCorasick.hpp"
+#include "../include/ChainLengths.hpp"
+#include "../include/DiskKmerCounter.hpp"
+#include "../include/FMIndex.hpp"
+#include "../include/OverlapGraph.hpp"
+#include "../include/OverlapKernel.hpp"
+#include "../include/PackedKmerSet.hpp"
+#include "../include/PrefixIndex.hpp"
+#include "../include/ReadStore.hpp"
+#include "../include/ThreadPool.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Nombre d'occurrences à partir duquel les k-mers sont regroupés dans le spectre comparé
+static constexpr size_t SPECTRUM_MAX = 64;
+
+// Nombre de vérifications échouées
+static size_t failures = 0;
+
+/**
+ * @brief Note le résultat d'une vérification et affiche son nom si elle échoue.
+ *
+ * @param ok Le résultat de la vérification.
+ * @param name Le nom de la vérification.
+**/
+static void check(bool ok, const std::string& name) {
+	if (!ok) {
+		std::cerr << "ÉCHEC : " << name << std::endl;
+		failures++;
+	}
+}
+
+/**
+ * @brief Génère des reads tirés d'un génome aléatoire, avec des bases N, des erreurs et un read poly-T
+ * (k-mer encodé ~0, compté à part dans les tables).
+ *
+ * @param seed La graine du générateur.
+ *
+ * @return Les reads générés.
+**/
+static std::vector<std::string> generate_reads(uint32_t seed) {
+	std::mt19937 random(seed);
+	auto uniform = [&](size_t min, size_t max) { return std::uniform_int_distribution<size_t>(min, max)(random); };
+
+	std::string genome(2000, 'A');
+	for (char& base : genome) {
+		base = "ACGT"[uniform(0, 3)];
+	}
+
+	std::vector<std::string> reads;
+	for (size_t i = 0; i < 3000; ++i) {
+		const size_t length = uniform(1, 120);
+		std::string read = genome.substr(uniform(0, genome.length() - length), length);
+		if (uniform(0, 9) == 0) {
+			read[uniform(0, length - 1)] = 'N';
+		}
+		if (uniform(0, 4) == 0) {
+			read[uniform(0, length - 1)] = "ACGT"[uniform(0, 3)];
+		}
+		reads.push_back(read);
+	}
+	reads.push_back(std::string(80, 'T'));
+	reads.push_back(std::string(40, 'T'));
+	return reads;
+}
+
+/**
+ * @brief Compte exactement les k-mers des reads dans une table ordonnée, référence des autres comptages.
+ *
+ * @param reads Les reads.
+ * @param k La longueur des k-mers.
+ *
+ * @return Le nombre d'occurrences de chaque k-mer.
+**/
+static std::map<std::string, uint32_t> reference_counts(const std::vector<std::string>& reads, size_t k) {
+	std::map<std::string, uint32_t> counts;
+	for (const std::string& read : reads) {
+		for (size_t i = 0; i + k <= read.length(); ++i) {
+			counts[read.substr(i, k)]++;
+		}
+	}
+	return counts;
+}
+
+/**
+ * @brief Donne le spectre d'un comptage de référence.
+ *
+ * @param counts Le nombre d'occurrences de chaque k-mer.
+ *
+ * @return Le nombre de k-mers distincts par nombre d'occurrences, de 0 à SPECTRUM_MAX.
+**/
+static std::vector<uint64_t> reference_histogram(const std::map<std::string, uint32_t>& counts) {
+	std::vector<uint64_t> histogram(SPECTRUM_MAX + 1, 0);
+	for (const auto& [kmer, count] : counts) {
+		histogram[std::min<size_t>(count, SPECTRUM_MAX)]++;
+	}
+	return histogram;
+}
+
+/**
+ * @brief Donne les k-mers solides d'un comptage de référence.
+ *
+ * @param counts Le nombre d'occurrences de chaque k-mer.
+ * @param min_count Le nombre minimal d'occurrences d'un k-mer gardé.
+ *
+ * @return Les k-mers solides.
+**/
+static std::set<std::string> reference_solid(const std::map<std::string, uint32_t>& counts, uint32_t min_count) {
+	std::set<std::string> solid;
+	for (const auto& [kmer, count] : counts) {
+		if (count >= min_count) {
+			solid.insert(kmer);
+		}
+	}
+	return solid;
+}
+
+/**
+ * @brief Donne les séquences d'un stockage compacté, décodées.
+ *
+ * @param reads Le stockage compacté.
+ *
+ * @return Les séquences, chacune une seule fois.
+**/
+static std::set<std::string> stored(const ReadStore& reads) {
+	std::set<std::string> sequences;
+	for (size_t id = 0; id < reads.size(); ++id) {
+		sequences.insert(reads.get(id));
+	}
+	return sequences;
+}
+
+/**
+ * @brief Vérifie que les séquences, avec ou sans base N, sont relues à l'identique depuis le stockage sur 2 bits.
+ *
+ * @param reads Les reads.
+**/
+static void test_read_store(const std::vector<std::string>& reads) {
+	ReadStore store;
+	for (const std::string& read : reads) {
+		store.add(read);
+	}
+	check(store.size() == reads.size(), "ReadStore : nombre de séquences");
+
+	bool round_trip = true;
+	std::string decoded;
+	for (size_t id = 0; id < reads.size(); ++id) {
+		const std::string& read = reads[id];
+		round_trip &= store.get(id) == read && store.length(id) == read.length();
+		round_trip &= store.has_n(id) == (read.find('N') != std::string::npos);
+		for (size_t pos = 0; pos < read.length(); pos += 7) {
+			round_trip &= store.base(id, pos) == read[pos];
+			decoded.clear();
+			store.decode(id, pos, decoded);
+			round_trip &= decoded == read.substr(pos);
+		}
+	}
+	check(round_trip, "ReadStore : aller-retour sur 2 bits");
+
+	// Des k-mers encodés (première base dans les bits de poids faible) copiés sans décodage, dont un de 32 bases
+	const size_t id = store.add_packed(0b11100100, 4);
+	check(store.get(id) == "ACGT" && store.length(id) == 4, "ReadStore : séquence déjà encodée");
+	const size_t full = store.add_packed(~uint64_t(0), 32);
+	check(store.get(full) == std::string(32, 'T'), "ReadStore : séquence déjà encodée de 32 bases");
+}
+
+/**
+ * @brief Vérifie qu'un index des chevauchements donne le plus long chevauchement de chaque séquence, calculé paire par paire.
+ *
+ * @param reads Les reads.
+ * @param name Le nom de l'index.
+**/
+template <typename Index>
+static void test_overlap_index(const std::vector<std::string>& reads, const std::string& name) {
+	// Séquences distinctes, comme les nœuds du graphe
+	const std::set<std::string> distinct(reads.begin(), reads.end());
+	ReadStore store;
+	std::vector<int32_t> ids;
+	for (const std::string& read : distinct) {
+		ids.push_back(store.add(read));
+	}
+
+	Index index(store, ids);
+	bool exact = true;
+	for (int32_t id : ids) {
+		int best = 0;
+		for (int32_t other : ids) {
+			if (other != id) {
+				best = std::max(best, compute_overlap(store, id, other, best + 1));
+			}
+		}
+		const Overlap found = index.best_overlap(id);
+		exact &= found.score == best && (best == 0 || compute_overlap(store, id, found.id) == best);
+	}
+	check(exact, name + " : plus long chevauchement de chaque séquence");
+}
+
+/**
+ * @brief Vérifie le calcul par tuiles des meilleurs chevauchements contre la comparaison de chaque séquence à tous les candidats,
+ * dans l'ordre, le premier successeur étant gardé en cas d'égalité. Les candidats s'étendent sur plusieurs tuiles.
+ *
+ * @param reads Les reads.
+ * @param min_overlap La longueur minimale d'un chevauchement.
+**/
+static void test_calculate_overlaps(const std::vector<std::string>& reads, int min_overlap) {
+	ReadStore store;
+	std::vector<int32_t> ids;
+	for (const std::string& read : reads) {
+		ids.push_back(store.add(read));
+	}
+
+	// Les séquences sont traitées par blocs, comme dans la construction du graphe
+	std::vector<Overlap> found(ids.size());
+	for (size_t begin = 0; begin < ids.size(); begin += 256) {
+		const size_t count = std::min<size_t>(256, ids.size() - begin);
+		calculate_overlaps(store, std::span<const int32_t>(ids).subspan(begin, count), ids, min_overlap, std::span<Overlap>(found).subspan(begin, count));
+	}
+
+	bool exact = true;
+	for (int32_t id : ids) {
+		Overlap best{-1, 0};
+		for (int32_t other : ids) {
+			if (store.length(other) == store.length(id) && store.equal(id, 0, other, 0, store.length(id))) {
+				continue;
+			}
+			const int score = compute_overlap(store, id, other, min_overlap);
+			if (score > best.score) {
+				best = {other, score};
+			}
+		}
+		exact &= found[id].id == best.id && found[id].score == best.score;
+	}
+	check(exact, "calculate_overlaps (minimum = " + std::to_string(min_overlap) + ") : meilleur chevauchement de chaque séquence");
+}
+
+/**
+ * @brief Vérifie la comparaison des fragments compactés (noyau vectorisé) et le calcul des chevauchements contre les chaînes.
+ *
+ * Les séquences, longues de plusieurs fois 128 bases, sont tirées d'un même génome : la moitié des fragments comparés
+ * commencent à une même position du génome et ne diffèrent que par des bases N ou des erreurs.
+ *
+ * @param seed La graine du générateur.
+**/
+static void test_packed_equal(uint32_t seed) {
+	std::mt19937 random(seed);
+	auto uniform = [&](size_t min, size_t max) { return std::uniform_int_distribution<size_t>(min, max)(random); };
+
+	std::string genome(4000, 'A');
+	for (char& base : genome) {
+		base = "ACGT"[uniform(0, 3)];
+	}
+	ReadStore store;
+	std::vector<std::string> sequences;
+	std::vector<size_t> starts;
+	for (size_t i = 0; i < 40; ++i) {
+		const size_t length = uniform(1, 1500);
+		starts.push_back(uniform(0, genome.length() - length));
+		std::string sequence = genome.substr(starts.back(), length);
+		if (uniform(0, 2) == 0) {
+			sequence[uniform(0, length - 1)] = (uniform(0, 1) == 0) ? 'N' : 'A';
+		}
+		sequences.push_back(sequence);
+		store.add(sequence);
+	}
+
+	bool exact = true;
+	for (size_t trial = 0; trial < 20000; ++trial) {
+		const size_t id1 = uniform(0, sequences.size() - 1);
+		const size_t id2 = uniform(0, sequences.size() - 1);
+		size_t pos1 = uniform(0, sequences[id1].length() - 1);
+		size_t pos2 = uniform(0, sequences[id2].length() - 1);
+		const size_t first = std::max(starts[id1], starts[id2]);
+		const size_t last = std::min(starts[id1] + sequences[id1].length(), starts[id2] + sequences[id2].length());
+		if (uniform(0, 1) == 0 && first < last) {
+			const size_t global = uniform(first, last - 1);
+			pos1 = global - starts[id1];
+			pos2 = global - starts[id2];
+		}
+		const size_t length = uniform(0, std::min(sequences[id1].length() - pos1, sequences[id2].length() - pos2));
+		exact &= store.equal(id1, pos1, id2, pos2, length) == (sequences[id1].compare(pos1, length, sequences[id2], pos2, length) == 0);
+	}
+	check(exact, std::string("ReadStore : comparaison des fragments (noyau ") + overlap_kernel_name() + ")");
+
+	bool overlaps = true;
+	for (size_t id1 = 0; id1 < sequences.size(); ++id1) {
+		for (size_t id2 = 0; id2 < sequences.size(); ++id2) {
+			const std::string& seq1 = sequences[id1];
+			const std::string& seq2 = sequences[id2];
+			size_t expected = std::min(seq1.length(), seq2.length());
+			while (expected > 0 && seq1.compare(seq1.length() - expected, expected, seq2, 0, expected) != 0) {
+				expected--;
+			}
+			overlaps &= compute_overlap(store, id1, id2) == static_cast<int>(expected);
+		}
+	}
+	check(overlaps, "compute_overlap : plus long suffixe égal à un préfixe");
+}
+
+/**
+ * @brief Donne la longueur du chemin partant d'un nœud en suivant les successeurs présents un par un, référence de ChainLengths.
+ *
+ * @param overlap_graph Le graphe de chevauchement.
+ * @param node Le nœud de départ.
+ *
+ * @return La longueur du chemin, nulle si le nœud n'a pas de successeur.
+**/
+static int32_t reference_chain_length(const OverlapGraph& overlap_graph, int32_t node) {
+	if (overlap_graph.successors[node] == -1) {
+		return 0;
+	}
+	std::set<int32_t> visited{node};
+	int32_t length = 1;
+	for (int32_t next = overlap_graph.successors[node]; next != -1 && overlap_graph.present[next] && visited.insert(next).second; next = overlap_graph.successors[next]) {
+		length++;
+	}
+	return length;
+}
+
+/**
+ * @brief Vérifie les longueurs des chemins et le choix des nœuds de départ de ChainLengths, mises à jour chaîne après chaîne,
+ * contre un parcours de tous les chemins à chaque étape.
+ *
+ * Le graphe aléatoire mêle chaînes, arbres entrants, cycles, successeurs absents et nœuds sans successeur.
+ *
+ * @param seed La graine du générateur.
+**/
+static void test_chain_lengths(uint32_t seed) {
+	std::mt19937 random(seed);
+	auto uniform = [&](size_t min, size_t max) { return std::uniform_int_distribution<size_t>(min, max)(random); };
+
+	const int32_t total = 300;
+	OverlapGraph overlap_graph;
+	overlap_graph.successors.assign(total, -1);
+	overlap_graph.present.assign(total, 0);
+	std::vector<int32_t> nodes;
+	for (int32_t node = 0; node < total; ++node) {
+		overlap_graph.successors[node] = (uniform(0, 9) == 0) ? -1 : (uniform(0, 2) == 0) ? uniform(0, total - 1) : std::min<int32_t>(node + uniform(1, 3), total - 1);
+		overlap_graph.present[node] = uniform(0, 9) != 0;
+		if (overlap_graph.present[node]) {
+			nodes.push_back(node);
+		}
+	}
+	overlap_graph.size = nodes.size();
+	overlap_graph.scores.assign(total, 0);
+
+	ChainLengths chain_lengths(overlap_graph, nodes);
+	bool lengths = true;
+	bool order = true;
+	std::vector<int32_t> chain;
+	for (size_t remaining = nodes.size(); remaining > 0;) {
+		// Le meilleur nœud : le plus long chemin, puis le plus petit identifiant
+		int32_t best = -1;
+		for (int32_t node : nodes) {
+			if (overlap_graph.present[node]) {
+				const int32_t length = reference_chain_length(overlap_graph, node);
+				lengths &= chain_lengths.length(node) == length;
+				if (best == -1 || length > reference_chain_length(overlap_graph, best)) {
+					best = node;
+				}
+			}
+		}
+		int32_t node = chain_lengths.best_node();
+		order &= node == best;
+
+		// Retirer la chaîne comme AssembleContigs
+		chain.clear();
+		while (true) {
+			overlap_graph.present[node] = 0;
+			remaining--;
+			chain.push_back(node);
+			const int32_t next = overlap_graph.successors[node];
+			if (next == -1 || !overlap_graph.present[next]) {
+				break;
+			}
+			node = next;
+		}
+		chain_lengths.remove_chain(chain);
+	}
+	check(lengths, "ChainLengths : longueurs des chemins après chaque chaîne retirée");
+	check(order && chain_lengths.best_node() == -1, "ChainLengths : ordre des nœuds de départ");
+}
+
+/**
+ * @brief Vérifie que le groupe de threads traite tous les blocs et relance l'exception d'un bloc après la fin des autres.
+ *
+ * @param pool Le groupe de threads.
+**/
+static void test_thread_pool(ThreadPool& pool) {
+	std::vector<uint8_t> done(1000, 0);
+	bool thrown = false;
+	try {
+		pool.parallel_for(0, done.size(), 7, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				done[i] = 1;
+			}
+			if (begin == 0) {
+				throw std::runtime_error("bloc");
+			}
+		});
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	check(thrown, "ThreadPool : exception relancée");
+	check(std::count(done.begin(), done.end(), 1) == static_cast<std::ptrdiff_t>(done.size()), "ThreadPool : tous les blocs traités");
+
+	// Le groupe reste utilisable et l'exception n'est relancée qu'une fois
+	std::vector<uint8_t> again(1000, 0);
+	pool.parallel_for(0, again.size(), 7, [&](size_t begin, size_t end) {
+		std::fill(again.begin() + begin, again.begin() + end, 1);
+	});
+	check(std::count(again.begin(), again.end(), 1) == static_cast<std::ptrdiff_t>(again.size()), "ThreadPool : réutilisation après une exception");
+}
+
+/**
+ * @brief Génère des séquences tirées d'un petit génome, dont beaucoup sont contenues dans d'autres, avec des copies identiques
+ * (jusqu'à trois exemplaires), des bases N et deux séquences vides.
+ *
+ * @param seed La graine du générateur.
+ *
+ * @return Les séquences générées.
+**/
+static std::vector<std::string> generate_containment_sequences(uint32_t seed) {
+	std::mt19937 random(seed);
+	auto uniform = [&](size_t min, size_t max) { return std::uniform_int_distribution<size_t>(min, max)(random); };
+
+	std::string genome(600, 'A');
+	for (char& base : genome) {
+		base = "ACGT"[uniform(0, 3)];
+	}
+
+	std::vector<std::string> sequences{""};
+	for (size_t i = 0; i < 300; ++i) {
+		const size_t length = uniform(1, 150);
+		std::string sequence = genome.substr(uniform(0, genome.length() - length), length);
+		if (uniform(0, 9) == 0) {
+			sequence[uniform(0, length - 1)] = 'N';
+		}
+		// Une séquence sur trois a une ou deux copies identiques
+		const size_t copies = (uniform(0, 2) == 0) ? uniform(2, 3) : 1;
+		for (size_t copy = 0; copy < copies; ++copy) {
+			sequences.push_back(sequence);
+		}
+	}
+	sequences.push_back("");
+	std::shuffle(sequences.begin() + 1, sequences.end(), random);
+	return sequences;
+}
+
+/**
+ * @brief Indique, pour chaque séquence, si elle est retirée comme contenue : elle apparaît dans une séquence plus longue,
+ * ou une copie identique la précède. Une seule copie de chaque groupe de séquences identiques est donc gardée.
+ *
+ * @param sequences Les séquences.
+ *
+ * @return 1 pour chaque séquence contenue.
+**/
+static std::vector<uint8_t> reference_contained(const std::vector<std::string>& sequences) {
+	std::vector<uint8_t> contained(sequences.size(), 0);
+	for (size_t i = 0; i < sequences.size(); ++i) {
+		for (size_t j = 0; j < sequences.size() && !contained[i]; ++j) {
+			const bool longer = sequences[j].length() > sequences[i].length();
+			contained[i] = j != i && (longer || j < i) && sequences[j].find(sequences[i]) != std::string::npos;
+		}
+	}
+	return contained;
+}
+
+/**
+ * @brief Vérifie le retrait des séquences contenues par l'index FM, copies identiques comprises, et le contenant nommé.
+ *
+ * @param sequences Les séquences.
+**/
+static void test_fm_containment(const std::vector<std::string>& sequences) {
+	ReadStore store;
+	std::vector<int32_t> ids;
+	for (const std::string& sequence : sequences) {
+		ids.push_back(store.add(sequence));
+	}
+	const std::vector<uint8_t> expected = reference_contained(sequences);
+
+	FMIndex index(store, ids);
+	std::vector<uint8_t> found(sequences.size());
+	bool named = true;
+	for (int32_t id : ids) {
+		found[id] = index.is_contained(id);
+
+		// Le contenant nommé est plus long, ou une copie identique d'identifiant plus petit
+		const int32_t container = index.container(id);
+		if (container == -1) {
+			named = named && !expected[id];
+		} else {
+			const std::string& text = sequences[container];
+			named = named && expected[id] && container != id && text.find(sequences[id]) != std::string::npos
+				&& (text.length() > sequences[id].length() || container < id);
+		}
+	}
+	check(found == expected, "FMIndex : séquences contenues, une copie de chaque groupe de séquences identiques gardée");
+	check(named, "FMIndex : contenant de chaque séquence contenue");
+}
+
+/**
+ * @brief Vérifie le retrait des séquences contenues par l'automate d'Aho-Corasick construit sur les seules séquences courtes,
+ * toutes les séquences le traversant une fois, copies identiques comprises.
+ *
+ * @param sequences Les séquences.
+ * @param short_length La longueur maximale des séquences cherchées, les plus longues étant toujours gardées.
+**/
+static void test_ac_containment(const std::vector<std::string>& sequences, size_t short_length) {
+	ReadStore store;
+	std::vector<int32_t> patterns;
+	for (const std::string& sequence : sequences) {
+		const int32_t id = store.add(sequence);
+		if (sequence.length() <= short_length) {
+			patterns.push_back(id);
+		}
+	}
+	std::vector<uint8_t> expected = reference_contained(sequences);
+	for (size_t id = 0; id < sequences.size(); ++id) {
+		expected[id] = expected[id] && sequences[id].length() <= short_length;
+	}
+
+	AhoCorasick automaton(store, patterns);
+	for (size_t id = 0; id < sequences.size(); ++id) {
+		automaton.scan(id);
+	}
+	std::vector<uint8_t> found(sequences.size(), 0);
+	for (int32_t id : patterns) {
+		found[id] = automaton.container(id) != -1;
+	}
+	check(found == expected, "AhoCorasick (séquences courtes ⩽ " + std::to_string(short_length) + ") : séquences contenues, une copie de chaque groupe de séquences identiques gardée");
+}
+
+/**
+ * @brief Vérifie le comptage en mémoire des k-mers encodés sur 64 bits, séquentiel et parallèle, k-mers contenant une base N compris :
+ * spectre et k-mers solides selon le nombre minimal d'occurrences.
+ *
+ * @param reads Les reads.
+ * @param k La longueur des k-mers.
+ * @param pool Le groupe de threads.
+**/
+static void test_packed_kmer_set(const std::vector<std::string>& reads, int k, ThreadPool& pool) {
+	const std::string name = "PackedKmerSet (k = " + std::to_string(k) + ")";
+	const std::map<std::string, uint32_t> counts = reference_counts(reads, k);
+	size_t expected_generated = 0;
+	for (const auto& [kmer, count] : counts) {
+		expected_generated += count;
+	}
+
+	PackedKmerSet sequential(k);
+	size_t generated = 0;
+	for (std::string_view read : reads) {
+		generated += sequential.add_kmers(read);
+	}
+	check(generated == expected_generated, name + " séquentiel : nombre de k-mers générés");
+
+	// Les reads sont répartis entre les threads par blocs, et les partitions comptées indépendamment
+	const std::vector<std::string_view> views(reads.begin(), reads.end());
+	PackedKmerSet parallel(k);
+	check(parallel.add_kmers(std::span<const std::string_view>(views), pool) == expected_generated, name + " parallèle : nombre de k-mers générés");
+
+	for (const PackedKmerSet* kmers : {&sequential, &parallel}) {
+		const std::string mode = name + (kmers == &sequential ? " séquentiel" : " parallèle");
+		check(kmers->size() == counts.size(), mode + " : nombre de k-mers uniques");
+		check(kmers->histogram(SPECTRUM_MAX) == reference_histogram(counts), mode + " : spectre");
+		for (uint32_t min_count : {1, 2, 3}) {
+			ReadStore solid;
+			kmers->store(solid, min_count);
+			check(stored(solid) == reference_solid(counts, min_count), mode + " : k-mers solides (n = " + std::to_string(min_count) + ")");
+		}
+	}
+}
+
+/**
+ * @brief Vérifie le filtre de Bloom des premières occurrences sur des reads dont la plupart des k-mers ne sont vus qu'une fois
+ * (reads aléatoires), mêlés à des reads couvrant un petit génome : aucun k-mer solide n'est perdu, et les faux positifs
+ * ne gardent pas plus de 1 % des k-mers vus une fois.
+ *
+ * @param seed La graine du générateur.
+ * @param k La longueur des k-mers.
+ * @param pool Le groupe de threads.
+**/
+static void test_bloom_filter(uint32_t seed, int k, ThreadPool& pool) {
+	const std::string name = "PackedKmerSet (k = " + std::to_string(k) + ") filtre de Bloom";
+	std::mt19937 random(seed);
+	auto uniform = [&](size_t min, size_t max) { return std::uniform_int_distribution<size_t>(min, max)(random); };
+	auto random_sequence = [&](size_t length) {
+		std::string sequence(length, 'A');
+		for (char& base : sequence) {
+			base = "ACGT"[uniform(0, 3)];
+		}
+		return sequence;
+	};
+
+	const std::string genome = random_sequence(500);
+	std::vector<std::string> reads;
+	for (size_t i = 0; i < 4000; ++i) {
+		reads.push_back((i % 4 == 0) ? genome.substr(uniform(0, 400), 100) : random_sequence(100));
+	}
+	const std::map<std::string, uint32_t> counts = reference_counts(reads, k);
+	size_t generated = 0;
+	for (const auto& [kmer, count] : counts) {
+		generated += count;
+	}
+
+	const std::vector<std::string_view> views(reads.begin(), reads.end());
+	PackedKmerSet filtered(k);
+	filtered.use_filter(generated);
+	filtered.add_kmers(std::span<const std::string_view>(views), pool);
+	ReadStore solid;
+	filtered.store(solid, 2);
+	const std::set<std::string> expected = reference_solid(counts, 2);
+	const std::set<std::string> found = stored(solid);
+	check(std::includes(found.begin(), found.end(), expected.begin(), expected.end()), name + " : k-mers solides gardés");
+	check(100 * (found.size() - expected.size()) <= counts.size() - expected.size(), name + " : moins de 1 % de faux positifs");
+}
+
+/**
+ * @brief Vérifie le comptage sur le disque contre le comptage exact, avec un budget forçant plusieurs passes.
+ *
+ * @param reads Les reads.
+ * @param k La longueur des k-mers.
+ * @param max_mem Le budget de mémoire, en octets.
+ * @param pool Le groupe de threads.
+**/
+static void test_disk_kmer_counter(const std::vector<std::string>& reads, int k, size_t max_mem, ThreadPool& pool) {
+	const std::string name = "DiskKmerCounter (k = " + std::to_string(k) + ", budget = " + std::to_string(max_mem) + ")";
+	const std::map<std::string, uint32_t> counts = reference_counts(reads, k);
+
+	for (bool bloom_filter : {false, true}) {
+		DiskKmerCounter counter(k, reads.size() * 100, max_mem);
+		for (const std::string& read : reads) {
+			counter.add_kmers(read);
+		}
+		ReadStore solid;
+		const std::vector<uint64_t> histogram = counter.count(2, bloom_filter, SPECTRUM_MAX, pool, solid);
+		const std::set<std::string> expected = reference_solid(counts, 2);
+		const std::set<std::string> found = stored(solid);
+		if (bloom_filter) {
+			check(std::includes(found.begin(), found.end(), expected.begin(), expected.end()), name + " filtre de Bloom : k-mers solides gardés");
+		} else {
+			check(histogram == reference_histogram(counts), name + " : spectre");
+			check(found == expected, name + " : k-mers solides");
+			check(solid.size() == expected.size(), name + " : k-mers solides uniques");
+		}
+	}
+}
+
+int main() {
+	const std::vector<std::string> reads = generate_reads(42);
+	ThreadPool pool(4);
+
+	test_read_store(reads);
+	test_overlap_index<PrefixIndex>(reads, "PrefixIndex");
+	test_overlap_index<FMIndex>(reads, "FMIndex");
+	test_packed_equal(7);
+	test_calculate_overlaps(reads, 1);
+	test_calculate_overlaps(reads, 30);
+	test_chain_lengths(11);
+	test_thread_pool(pool);
+	test_fm_containment(generate_containment_sequences(5));
+	test_ac_containment(generate_containment_sequences(5), 150);
+	test_ac_containment(generate_containment_sequences(5), 60);
+	for (int k : {5, 21, 32}) {
+		test_packed_kmer_set(reads, k, pool);
+		test_bloom_filter(13, k, pool);
+		test_disk_kmer_counter(reads, k, 1 << 20, pool);
+		test_disk_kmer_counter(reads, k, DiskKmerCounter::min_memory(), pool);
+	}
+
+	if (failures > 0) {
+		std::cerr << failures << " vérification(s) échouée(s)" << std::endl;
+		return 1;
+	}
+	std::cout << "Tests unitaires : OK" << std::endl;
+	return 0;
+}